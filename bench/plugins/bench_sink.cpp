@@ -0,0 +1,72 @@
+/*
+ * Copyright (C) 2024 Geon Technologies, LLC
+ *
+ * This file is part of composite.
+ *
+ * composite is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * composite is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+// Sink measuring throughput and timestamp latency of the packets it receives
+
+#include "payload.hpp"
+
+#include "composite/component.hpp"
+#include "composite/input_port.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace composite::bench {
+
+template <typename T>
+class sink : public component {
+public:
+    sink() : component("bench_sink") {
+        add_port(&m_in_port);
+        // Read back by composite-cli --bench once the application stops
+        add_property("bench_packets", &m_packets);
+        add_property("bench_bytes", &m_bytes);
+        add_property("bench_latency_sum_ns", &m_latency_sum);
+        add_property("bench_latency_max_ns", &m_latency_max);
+    }
+
+    auto process() -> retval override {
+        auto [data, ts] = m_in_port.get_data();
+        if (data == nullptr) {
+            return retval::NOOP;
+        }
+        auto latency = static_cast<uint64_t>(std::max(age(ts), int64_t{0}));
+        ++m_packets;
+        m_bytes += data->size() * sizeof(T);
+        m_latency_sum += latency;
+        m_latency_max = std::max(m_latency_max, latency);
+        return retval::NORMAL;
+    }
+
+private:
+    input_port<payload_type<T>> m_in_port{"in"};
+    uint64_t m_packets{0};
+    uint64_t m_bytes{0};
+    uint64_t m_latency_sum{0};
+    uint64_t m_latency_max{0};
+
+}; // class sink
+
+auto create_sink(std::string_view type) -> std::shared_ptr<component> {
+    return create_for_type<sink>(type);
+}
+
+} // namespace composite::bench
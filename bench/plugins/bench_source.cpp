@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) 2024 Geon Technologies, LLC
+ *
+ * This file is part of composite.
+ *
+ * composite is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * composite is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+// Rate-controlled source of fixed-size packets stamped with the wall clock
+
+#include "payload.hpp"
+
+#include "composite/component.hpp"
+#include "composite/output_port.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <thread>
+
+namespace composite::bench {
+
+template <typename T>
+class source : public component {
+public:
+    source() : component("bench_source") {
+        add_port(&m_out_port);
+        add_property("packet_size", &m_packet_size);
+        add_property("rate", &m_rate);
+    }
+
+    auto start() -> void override {
+        m_sent = 0;
+        m_begin = std::chrono::steady_clock::now();
+        component::start();
+    }
+
+    auto process() -> retval override {
+        if (m_rate > 0.0) {
+            // Pace packets against the start time so delays do not accumulate
+            auto due = m_begin + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(static_cast<double>(m_sent) / m_rate));
+            std::this_thread::sleep_until(due);
+        }
+        auto data = std::make_shared<std::vector<T>>(m_packet_size, T{1});
+        m_out_port.send_data(std::move(data), now());
+        ++m_sent;
+        return retval::NO_YIELD;
+    }
+
+private:
+    output_port<payload_type<T>> m_out_port{"out"};
+    uint32_t m_packet_size{1024}; // samples per packet
+    double m_rate{0.0}; // packets per second, 0 is unthrottled
+    uint64_t m_sent{0};
+    std::chrono::steady_clock::time_point m_begin;
+
+}; // class source
+
+auto create_source(std::string_view type) -> std::shared_ptr<component> {
+    return create_for_type<source>(type);
+}
+
+} // namespace composite::bench
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2024 Geon Technologies, LLC
+ *
+ * This file is part of composite.
+ *
+ * composite is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * composite is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+// Pass-through stage performing a tunable amount of arithmetic per sample
+
+#include "payload.hpp"
+
+#include "composite/component.hpp"
+#include "composite/input_port.hpp"
+#include "composite/output_port.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace composite::bench {
+
+template <typename T>
+class stage : public component {
+public:
+    stage() : component("bench_stage") {
+        add_port(&m_in_port);
+        add_port(&m_out_port);
+        add_property("work", &m_work);
+    }
+
+    auto process() -> retval override {
+        auto [data, ts] = m_in_port.get_data();
+        if (data == nullptr) {
+            return retval::NOOP;
+        }
+        for (auto& sample : *data) {
+            for (uint32_t i = 0; i < m_work; ++i) {
+                sample = sample * m_scale + m_offset;
+            }
+        }
+        m_out_port.send_data(std::move(data), ts);
+        return retval::NORMAL;
+    }
+
+private:
+    input_port<payload_type<T>> m_in_port{"in"};
+    output_port<payload_type<T>> m_out_port{"out"};
+    uint32_t m_work{0}; // multiply-adds per sample
+    T m_scale{1}; // members rather than constants so the work is not folded away
+    T m_offset{0};
+
+}; // class stage
+
+auto create_stage(std::string_view type) -> std::shared_ptr<component> {
+    return create_for_type<stage>(type);
+}
+
+} // namespace composite::bench
@@ -0,0 +1,30 @@
+/*
+ * Copyright (C) 2024 Geon Technologies, LLC
+ *
+ * This file is part of composite.
+ *
+ * composite is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * composite is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+ 
+// Factory table for the load-generation components
+
+#include "payload.hpp"
+
+#include "composite/plugin.hpp"
+
+COMPOSITE_EXPORT_FACTORIES(
+    {"bench_source", nullptr, &composite::bench::create_source},
+    {"bench_stage", nullptr, &composite::bench::create_stage},
+    {"bench_sink", nullptr, &composite::bench::create_sink}
+)
@@ -0,0 +1,77 @@
+/*
+ * Copyright (C) 2024 Geon Technologies, LLC
+ *
+ * This file is part of composite.
+ *
+ * composite is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * composite is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include "composite/component.hpp"
+#include "composite/timestamp.hpp"
+
+#include <chrono>
+#include <complex>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace composite::bench {
+
+// Payloads carried between the benchmark components
+template <typename T>
+using payload_type = std::shared_ptr<std::vector<T>>;
+
+// Wall-clock time as a composite timestamp
+inline auto now() -> timestamp {
+    auto since_epoch = std::chrono::system_clock::now().time_since_epoch();
+    auto secs = std::chrono::duration_cast<std::chrono::seconds>(since_epoch);
+    auto frac = std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch - secs);
+    return timestamp{static_cast<uint32_t>(secs.count()), static_cast<uint64_t>(frac.count()) * 1000};
+}
+
+// Nanoseconds elapsed since a timestamp produced by now()
+inline auto age(const timestamp& ts) -> int64_t {
+    auto then = std::chrono::seconds{ts.seconds} + std::chrono::nanoseconds{ts.picoseconds / 1000};
+    auto elapsed = std::chrono::system_clock::now().time_since_epoch() - then;
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+// Instantiate a component template for the sample type named by a create argument
+template <template <typename> typename Component>
+auto create_for_type(std::string_view type) -> std::shared_ptr<component> {
+    if (type == "int8") {
+        return std::make_shared<Component<int8_t>>();
+    } else if (type == "int16") {
+        return std::make_shared<Component<int16_t>>();
+    } else if (type == "int32") {
+        return std::make_shared<Component<int32_t>>();
+    } else if (type == "float") {
+        return std::make_shared<Component<float>>();
+    } else if (type == "double") {
+        return std::make_shared<Component<double>>();
+    } else if (type == "cfloat") {
+        return std::make_shared<Component<std::complex<float>>>();
+    }
+    return nullptr;
+}
+
+// Factories exported by the module
+auto create_source(std::string_view type) -> std::shared_ptr<component>;
+auto create_stage(std::string_view type) -> std::shared_ptr<component>;
+auto create_sink(std::string_view type) -> std::shared_ptr<component>;
+
+} // namespace composite::bench
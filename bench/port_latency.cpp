@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) 2024 Geon Technologies, LLC
+ *
+ * This file is part of composite.
+ *
+ * composite is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * composite is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+// Measures the one-way latency of a port hop for each input port wait
+// strategy by bouncing a buffer between two threads.
+
+#include "composite/pipeline.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fmt/core.h>
+#include <memory>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace {
+
+constexpr int DEFAULT_ITERATIONS{100000};
+constexpr std::chrono::microseconds HYBRID_SPIN_TIME{50};
+
+using buffer_type = std::shared_ptr<int>;
+
+auto measure(composite::wait_strategy strategy, std::chrono::nanoseconds spin_time, int iterations) -> std::vector<double> {
+    auto ping_out = composite::output_port<buffer_type>{"ping_out"};
+    auto ping_in = composite::input_port<buffer_type>{"ping_in"};
+    auto pong_out = composite::output_port<buffer_type>{"pong_out"};
+    auto pong_in = composite::input_port<buffer_type>{"pong_in"};
+    composite::connect(ping_out, ping_in);
+    composite::connect(pong_out, pong_in);
+    ping_in.wait_strategy(strategy, spin_time);
+    pong_in.wait_strategy(strategy, spin_time);
+
+    // Echo every buffer straight back
+    auto echo = std::jthread{[&ping_in, &pong_out, iterations] {
+        for (auto i = 0; i < iterations; ++i) {
+            auto [data, ts] = ping_in.get_data();
+            pong_out.send_data(std::move(data), ts);
+        }
+    }};
+
+    auto hops = std::vector<double>{};
+    hops.reserve(static_cast<std::size_t>(iterations));
+    auto data = std::make_shared<int>(0);
+    for (auto i = 0; i < iterations; ++i) {
+        auto begin = std::chrono::steady_clock::now();
+        ping_out.send_data(std::move(data), {});
+        data = std::get<0>(pong_in.get_data());
+        auto round_trip = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin);
+        hops.emplace_back(round_trip.count() / 2);
+    }
+    std::ranges::sort(hops);
+    return hops;
+}
+
+} // namespace
+
+auto main(int argc, char** argv) -> int {
+    // Spinning strategies assume the two threads run on separate cores
+    const auto iterations = (argc > 1) ? std::atoi(argv[1]) : DEFAULT_ITERATIONS;
+    if (iterations <= 0) {
+        fmt::print(stderr, "usage: {} [iterations]\n", argv[0]);
+        return 1;
+    }
+    const auto strategies = std::vector<std::pair<std::string_view, composite::wait_strategy>>{
+        {"blocking", composite::wait_strategy::BLOCKING},
+        {"spin", composite::wait_strategy::SPIN},
+        {"yield", composite::wait_strategy::YIELD},
+        {"hybrid", composite::wait_strategy::HYBRID},
+    };
+    fmt::print("{:<10} {:>12} {:>12} {:>12}\n", "strategy", "p50 (ns)", "p99 (ns)", "max (ns)");
+    for (const auto& [name, strategy] : strategies) {
+        auto hops = measure(strategy, HYBRID_SPIN_TIME, iterations);
+        fmt::print("{:<10} {:>12.0f} {:>12.0f} {:>12.0f}\n",
+            name, hops[hops.size() / 2], hops[hops.size() * 99 / 100], hops.back());
+    }
+    return 0;
+}
@@ -21,10 +21,18 @@
 
 #include "component.hpp"
 #include "lifecycle.hpp"
+#include "memory_budget.hpp"
+#include "watchdog.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <string_view>
+#include <unordered_map>
 #include <vector>
 
 namespace composite {
@@ -37,48 +45,232 @@ public:
       m_name(name) {
     }
 
+    // Components may outlive the application, so they must stop charging
+    // its memory budget
+    ~application() override {
+        stop_watchdog();
+        const auto lock = std::scoped_lock{m_components_mtx};
+        detach_budget();
+    }
+
     auto name() const noexcept -> const std::string& {
         return m_name;
     }
 
     auto initialize() -> void override {
+        const auto lock = std::scoped_lock{m_components_mtx};
         for (auto& component : m_components) {
             component->initialize();
         }
     }
 
     auto start() -> void override {
+        const auto lock = std::scoped_lock{m_components_mtx};
         for (auto& component : m_components) {
             component->start();
         }
+        m_running = true;
+        if (m_watchdog != nullptr) {
+            m_watchdog->start();
+        }
     }
 
     auto stop() -> void override {
+        // The watchdog samples through components(), so stop it before locking
+        stop_watchdog();
+        const auto lock = std::scoped_lock{m_components_mtx};
         for (auto& component : m_components) {
             component->stop();
         }
+        m_running = false;
+    }
+
+    auto running() const noexcept -> bool {
+        return m_running;
+    }
+
+    // Limit the total bytes queued across all input ports
+    auto memory_budget(std::size_t bytes) -> void {
+        const auto lock = std::scoped_lock{m_components_mtx};
+        m_budget.limit(bytes);
+        for (const auto& comp : m_components) {
+            for (auto port : comp->ports()) {
+                port->budget(&m_budget);
+            }
+        }
+        m_budget_enabled = true;
+    }
+
+    auto memory_budget() const noexcept -> const composite::memory_budget& {
+        return m_budget;
+    }
+
+    // Report components and ports that stop making progress for longer than
+    // limit, checking every period from a separate thread while running
+    auto watchdog(
+      std::chrono::nanoseconds period,
+      std::chrono::nanoseconds limit,
+      composite::watchdog::callback_type callback
+    ) -> void {
+        stop_watchdog();
+        auto dog = std::make_unique<composite::watchdog>([this] { return components(); }, period, limit, std::move(callback));
+        const auto lock = std::scoped_lock{m_components_mtx};
+        m_watchdog = std::move(dog);
+        if (m_running) {
+            m_watchdog->start();
+        }
     }
 
+    // Components are indexed by id, which must not change once added
     auto add_component(component_ptr comp) -> void {
+        const auto lock = std::scoped_lock{m_components_mtx};
+        if (m_budget_enabled) {
+            for (auto port : comp->ports()) {
+                port->budget(&m_budget);
+            }
+        }
         m_components.emplace_back(comp);
+        m_index.try_emplace(comp->id(), comp.get());
+        if (m_running) {
+            // Joining a live graph, bring it up to the application's state
+            comp->initialize();
+            comp->start();
+        }
     }
 
-    auto get_component(std::string_view id) const -> component* {
-        for (const auto& component : m_components) {
-            if (component->id() == id) {
-                return component.get();
+    auto remove_component(std::string_view id) -> bool {
+        auto comp = component_ptr{};
+        auto upstream = std::vector<component_ptr>{};
+        {
+            const auto lock = std::scoped_lock{m_components_mtx};
+            auto iter = std::ranges::find_if(m_components, [id](const auto& comp) {
+                return comp->id() == id;
+            });
+            if (iter == m_components.end()) {
+                return false;
             }
+            comp = *iter;
+            // Detach every output feeding this component before it goes away
+            const auto comp_ports = comp->ports();
+            for (const auto& other : m_components) {
+                for (auto out_port : other->ports()) {
+                    for (auto in_port : comp_ports) {
+                        out_port->disconnect(in_port);
+                    }
+                }
+            }
+            m_components.erase(iter);
+            if (auto entry = m_index.find(id); entry != m_index.end()) {
+                m_index.erase(entry);
+            }
+            // Fall back to the next component sharing the id, as a scan would
+            if (auto next = std::ranges::find_if(m_components, [id](const auto& other) { return other->id() == id; });
+                next != m_components.end()) {
+                m_index.try_emplace((*next)->id(), next->get());
+            }
+            upstream = m_components;
+        }
+        // A sender blocked on one of the removed queues can hold it for a
+        // while, so wait for senders to let go without holding the lock
+        for (const auto& other : upstream) {
+            for (auto out_port : other->ports()) {
+                out_port->synchronize();
+            }
+        }
+        if (m_running) {
+            comp->stop();
         }
-        return nullptr;
+        for (auto port : comp->ports()) {
+            port->budget(nullptr);
+        }
+        return true;
+    }
+
+    auto components() const -> std::vector<component_ptr> {
+        const auto lock = std::scoped_lock{m_components_mtx};
+        return m_components;
+    }
+
+    auto get_component(std::string_view id) const -> component* {
+        const auto lock = std::scoped_lock{m_components_mtx};
+        return find_component(id);
+    }
+
+    auto connect(
+      std::string_view output_id,
+      std::string_view output_port_name,
+      std::string_view input_id,
+      std::string_view input_port_name
+    ) -> bool {
+        const auto lock = std::scoped_lock{m_components_mtx};
+        auto output_comp = find_component(output_id);
+        if (output_comp == nullptr) {
+            return false;
+        }
+        return output_comp->connect(output_port_name, find_component(input_id), input_port_name);
+    }
+
+    auto disconnect(
+      std::string_view output_id,
+      std::string_view output_port_name,
+      std::string_view input_id,
+      std::string_view input_port_name
+    ) -> bool {
+        const auto lock = std::scoped_lock{m_components_mtx};
+        auto output_comp = find_component(output_id);
+        if (output_comp == nullptr) {
+            return false;
+        }
+        return output_comp->disconnect(output_port_name, find_component(input_id), input_port_name);
     }
 
     auto clear() -> void {
+        const auto lock = std::scoped_lock{m_components_mtx};
+        detach_budget();
         m_components.clear();
+        m_index.clear();
     }
 
 private:
+    struct id_hash {
+        using is_transparent = void;
+        auto operator()(std::string_view id) const noexcept -> std::size_t {
+            return std::hash<std::string_view>{}(id);
+        }
+    };
+
     std::string m_name;
+    composite::memory_budget m_budget;
+    bool m_budget_enabled{false};
     std::vector<component_ptr> m_components;
+    std::unordered_map<std::string, component*, id_hash, std::equal_to<>> m_index;
+    mutable std::mutex m_components_mtx;
+    std::atomic_bool m_running{false};
+    std::unique_ptr<composite::watchdog> m_watchdog;
+
+    auto stop_watchdog() -> void {
+        auto dog = [this] {
+            const auto lock = std::scoped_lock{m_components_mtx};
+            return m_watchdog.get();
+        }();
+        if (dog != nullptr) {
+            dog->stop();
+        }
+    }
+
+    // Caller must hold m_components_mtx
+    auto detach_budget() -> void {
+        for (const auto& comp : m_components) {
+            for (auto port : comp->ports()) {
+                port->budget(nullptr);
+            }
+        }
+    }
+
+    auto find_component(std::string_view id) const -> component* {
+        auto iter = m_index.find(id);
+        return (iter != m_index.end()) ? iter->second : nullptr;
+    }
 
 }; // class application
 
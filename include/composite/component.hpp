@@ -23,11 +23,23 @@
 #include "lifecycle.hpp"
 #include "output_port.hpp"
 #include "port_set.hpp"
+#include "profiler.hpp"
 #include "property_set.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <optional>
+#include <pthread.h>
+#include <sched.h>
 #include <string>
 #include <string_view>
+#include <sys/resource.h>
 #include <thread>
+#include <vector>
 
 namespace composite {
 
@@ -40,6 +52,7 @@ enum class retval : int {
 
 class component : public lifecycle {
     static constexpr int DEFAULT_DELAY{1000000};
+    static constexpr int NICE_MAX{19};
 
 public:
     explicit component(std::string_view name) :
@@ -60,6 +73,9 @@ public:
 
     auto id(std::string_view id) -> void {
         m_id = id;
+        for (auto port : m_port_set.ports()) {
+            port->component_id(m_id);
+        }
     }
 
     auto initialize() -> void override {
@@ -67,7 +83,13 @@ public:
     }
 
     auto start() -> void override {
-        m_thread = std::jthread(&component::thread_func, this);
+        auto applied = std::promise<bool>{};
+        auto applied_future = applied.get_future();
+        m_thread = std::jthread([this, applied = std::move(applied)](std::stop_token token) mutable {
+            applied.set_value(apply_priority());
+            thread_func(token);
+        });
+        m_priority_applied = applied_future.get();
     }
 
     auto stop() -> void override {
@@ -79,14 +101,79 @@ public:
 
     virtual auto process() -> retval = 0;
 
+    // Scheduling priority of the component thread. Positive values request
+    // SCHED_FIFO at that priority, negative values lower the thread's nice
+    // level so background work yields to everything else.
+    auto priority() const noexcept -> int {
+        return m_priority;
+    }
+
+    auto priority(int value) noexcept -> void {
+        m_priority = value;
+    }
+
+    // Whether the requested priority could be applied to the running thread
+    auto priority_applied() const noexcept -> bool {
+        return m_priority_applied;
+    }
+
+    // Longest a single process() call may take, from its first dequeue, before
+    // counting as a miss. Calls returning NOOP are not counted.
+    auto deadline() const noexcept -> std::chrono::nanoseconds {
+        return m_deadline;
+    }
+
+    auto deadline(std::chrono::nanoseconds value) noexcept -> void {
+        m_deadline = value;
+    }
+
+    auto deadline_misses() const noexcept -> uint64_t {
+        return m_deadline_misses;
+    }
+
+    // Completed process() calls, sampled by the watchdog to detect stalls
+    auto heartbeat() const noexcept -> uint64_t {
+        return m_heartbeat.load(std::memory_order_relaxed);
+    }
+
+    // Whether the component thread is currently inside process()
+    auto processing() const noexcept -> bool {
+        return m_processing.load(std::memory_order_relaxed);
+    }
+
+    auto last_result() const noexcept -> retval {
+        return m_last_result.load(std::memory_order_relaxed);
+    }
+
     auto add_port(port* port) {
         m_port_set.add_port(port);
+        port->component_id(m_id);
     }
 
     auto get_port(std::string_view name) -> port* {
         return m_port_set.get_port(name);
     }
 
+    auto port_at(std::size_t index) const -> port* {
+        return m_port_set.port_at(index);
+    }
+
+    auto port_index(std::string_view name) const -> std::optional<std::size_t> {
+        return m_port_set.port_index(name);
+    }
+
+    auto ports() const -> std::vector<port*> {
+        return m_port_set.ports();
+    }
+
+    // The input port to read next: the one with the highest connection
+    // priority that has data queued, or nullptr if every input is empty.
+    // Components reading several inputs use it to serve critical flows
+    // before bulk ones, whatever their thread priority.
+    auto next_input() const noexcept -> port* {
+        return m_port_set.next_queued();
+    }
+
     auto connect(
       std::string_view output_port_name,
       component* other,
@@ -110,11 +197,35 @@ public:
         return true;
     }
 
+    auto disconnect(
+      std::string_view output_port_name,
+      component* other,
+      std::string_view input_port_name
+    ) -> bool {
+        auto out_port = get_port(output_port_name);
+        if (out_port == nullptr) {
+            return false;
+        }
+        if (other == nullptr) {
+            return false;
+        }
+        auto in_port = other->get_port(input_port_name);
+        if (in_port == nullptr) {
+            return false;
+        }
+        out_port->disconnect(in_port);
+        return true;
+    }
+
     template <typename T>
     auto add_property(std::string_view name, T* prop) -> void {
         m_prop_set.add_property(name, prop);
     }
 
+    auto has_property(std::string_view name) const -> bool {
+        return m_prop_set.has_property(name);
+    }
+
     template <typename T>
     auto set_property(std::string_view name, T value) -> void {
         m_prop_set.set_property(name, value);
@@ -130,13 +241,58 @@ private:
     std::string m_id;
     std::jthread m_thread;
     std::chrono::nanoseconds m_delay{DEFAULT_DELAY};
+    int m_priority{0};
+    bool m_priority_applied{true};
+    std::chrono::nanoseconds m_deadline{0};
+    std::atomic<uint64_t> m_deadline_misses{0};
+    std::atomic<uint64_t> m_heartbeat{0}; // written only by the component thread
+    std::atomic_bool m_processing{false};
+    std::atomic<retval> m_last_result{retval::NORMAL};
     port_set m_port_set;
     property_set m_prop_set;
 
+    auto apply_priority() -> bool {
+        if (m_priority > 0) {
+            auto param = sched_param{};
+            param.sched_priority = std::clamp(m_priority, sched_get_priority_min(SCHED_FIFO), sched_get_priority_max(SCHED_FIFO));
+            return pthread_setschedparam(pthread_self(), SCHED_FIFO, &param) == 0;
+        }
+        if (m_priority < 0) {
+            // Linux applies nice values per thread
+            return setpriority(PRIO_PROCESS, 0, std::min(-m_priority, NICE_MAX)) == 0;
+        }
+        return true;
+    }
+
     auto thread_func(std::stop_token token) -> void {
+        profiler::instance().thread_name(m_id);
         while (!token.stop_requested()) {
-            auto res = process();
+            m_processing.store(true, std::memory_order_relaxed);
+            auto res = [this] {
+                const auto scope = profile_scope{"process", "component"};
+                if (m_deadline.count() == 0) {
+                    return process();
+                }
+                // Time from the first dequeue, so waiting for input is not
+                // counted, or from the call for components without inputs
+                auto begin = std::chrono::steady_clock::now();
+                auto dequeued = std::chrono::steady_clock::time_point{};
+                process_dequeue_time = &dequeued;
+                auto res = process();
+                process_dequeue_time = nullptr;
+                if (dequeued != std::chrono::steady_clock::time_point{}) {
+                    begin = dequeued;
+                }
+                if (res != retval::NOOP && std::chrono::steady_clock::now() - begin > m_deadline) {
+                    ++m_deadline_misses;
+                }
+                return res;
+            }();
+            m_processing.store(false, std::memory_order_relaxed);
+            m_heartbeat.store(m_heartbeat.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            m_last_result.store(res, std::memory_order_relaxed);
             if (res == retval::NOOP) {
+                const auto scope = profile_scope{"noop sleep", "component"};
                 std::this_thread::sleep_for(m_delay);
             } else if (res == retval::FINISH) {
                 break;
@@ -19,8 +19,11 @@
  
 #pragma once
 
+#include "memory_budget.hpp"
 #include "port.hpp"
+#include "profiler.hpp"
 #include "timestamp.hpp"
+#include "wait_strategy.hpp"
 
 #include <atomic>
 #include <chrono>
@@ -28,6 +31,9 @@
 #include <deque>
 #include <limits>
 #include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
 #include <tuple>
 #include <typeinfo>
 #include <vector>
@@ -40,49 +46,163 @@ class output_port;
 template <traits::smart_ptr T>
 class input_port : public port {
     static constexpr int WAIT_DURATION{2}; // seconds
+    static constexpr std::chrono::milliseconds BLOCK_POLL_PERIOD{1};
 public:
     using value_type = typename T::element_type;
     using buffer_type = T;
     using timestamp_type = timestamp;
 
-    explicit input_port(std::string_view name) : port(name) {}
+    explicit input_port(std::string_view name) :
+      port(name) {
+        component_id({});
+    }
 
     ~input_port() override {
         m_eos = true;
         m_data_cv.notify_all();
+        m_space_cv.notify_all();
+        clear();
     }
 
     auto depth() const -> std::size_t {
         return m_depth;
     }
 
-    auto depth(std::size_t value) -> void {
+    auto depth(std::size_t value) -> void override {
         const auto lock = std::scoped_lock{m_data_mtx};
         m_depth = value;
     }
 
+    auto max_bytes() const -> std::size_t {
+        return m_max_bytes;
+    }
+
+    auto max_bytes(std::size_t value) -> void override {
+        const auto lock = std::scoped_lock{m_data_mtx};
+        m_max_bytes = value;
+    }
+
+    auto overflow() const -> overflow_policy {
+        return m_overflow;
+    }
+
+    auto overflow(overflow_policy value) -> void override {
+        const auto lock = std::scoped_lock{m_data_mtx};
+        m_overflow = value;
+    }
+
+    auto budget(memory_budget* value) -> void override {
+        const auto lock = std::scoped_lock{m_data_mtx};
+        if (m_budget != nullptr) {
+            m_budget->release(m_bytes);
+        }
+        if (value != nullptr) {
+            // Data already queued is charged to the new budget regardless of its limit
+            value->acquire(m_bytes);
+        }
+        m_budget = value;
+    }
+
     auto size() -> std::size_t {
         const auto lock = std::scoped_lock{m_data_mtx};
         return m_queue.size();
     }
 
+    auto bytes() const noexcept -> std::size_t override {
+        return m_bytes;
+    }
+
+    auto dropped() const noexcept -> uint64_t override {
+        return m_dropped;
+    }
+
+    // Name profiler spans after the owning component as well as the port,
+    // since enqueue spans are recorded on the producer's thread
+    auto component_id(std::string_view id) -> void override {
+        auto& profiler = profiler::instance();
+        m_enqueue_label.store(profiler.intern(profile_label("enqueue", id)), std::memory_order_release);
+        m_dequeue_label.store(profiler.intern(profile_label("dequeue", id)), std::memory_order_release);
+        m_wait_label.store(profiler.intern(profile_label("wait", id)), std::memory_order_release);
+    }
+
+    auto queued() const noexcept -> std::size_t override {
+        return m_count.load(std::memory_order_acquire);
+    }
+
+    auto dequeued() const noexcept -> uint64_t override {
+        return m_dequeued.load(std::memory_order_relaxed);
+    }
+
+    auto full() const noexcept -> bool override {
+        return m_count.load(std::memory_order_relaxed) >= m_depth.load(std::memory_order_relaxed) ||
+          (m_bytes > 0 && m_bytes >= m_max_bytes.load(std::memory_order_relaxed));
+    }
+
+    // Whether the consumer is currently waiting in get_data() for data
+    auto waiting() const noexcept -> bool override {
+        return m_waiting.load(std::memory_order_relaxed);
+    }
+
     auto clear() -> void {
         const auto lock = std::scoped_lock{m_data_mtx};
         m_queue.clear();
+        m_count.store(0, std::memory_order_release);
+        if (m_budget != nullptr) {
+            m_budget->release(m_bytes);
+        }
+        m_bytes = 0;
+        m_space_cv.notify_all();
     }
 
     auto type_id() const noexcept -> std::size_t override {
         return typeid(T).hash_code();
     }
 
+    auto wait_strategy() const -> composite::wait_strategy {
+        return m_wait_strategy;
+    }
+
+    auto wait_strategy(composite::wait_strategy value, std::chrono::nanoseconds spin_time) -> void override {
+        m_wait_strategy = value;
+        m_spin_time = spin_time;
+    }
+
     auto get_data() -> std::tuple<buffer_type, timestamp_type> {
         using namespace std::chrono_literals;
+        auto wait_time = std::chrono::nanoseconds{WAIT_DURATION*1s};
+        const auto waiting = waiting_scope{m_waiting};
+        if (const auto strategy = m_wait_strategy.load(); strategy != composite::wait_strategy::BLOCKING) {
+            const auto scope = profile_scope{m_wait_label.load(std::memory_order_acquire), "port"};
+            // Only a hybrid wait falls back to parking on the condition variable
+            const auto hybrid = (strategy == composite::wait_strategy::HYBRID);
+            auto ready = spin(strategy, hybrid ? m_spin_time.load() : wait_time);
+            if (ready || !hybrid) {
+                wait_time = 0ns;
+            }
+        }
         auto lock = std::unique_lock{m_data_mtx};
-        m_data_cv.wait_for(lock, WAIT_DURATION*1s, [this]{ return !m_queue.empty() || m_eos; });
+        if (wait_time > 0ns) {
+            const auto scope = profile_scope{m_wait_label.load(std::memory_order_acquire), "port"};
+            m_data_cv.wait_for(lock, wait_time, [this]{ return !m_queue.empty() || m_eos; });
+        }
         if (!m_queue.empty()) {
-            auto retval = std::move(m_queue.front());
+            const auto scope = profile_scope{m_dequeue_label.load(std::memory_order_acquire), "port"};
+            auto entry = std::move(m_queue.front());
             m_queue.pop_front();
-            return retval;
+            m_count.store(m_queue.size(), std::memory_order_release);
+            m_dequeued.store(m_dequeued.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            m_bytes -= entry.bytes;
+            if (m_budget != nullptr) {
+                m_budget->release(entry.bytes);
+            }
+            m_space_cv.notify_one();
+            if (deadline().count() > 0 && clock_type::now() - entry.enqueued > deadline()) {
+                ++m_deadline_misses;
+            }
+            if (auto dequeued = process_dequeue_time; dequeued != nullptr && *dequeued == clock_type::time_point{}) {
+                *dequeued = clock_type::now();
+            }
+            return std::move(entry.data);
         }
         return {};
     }
@@ -95,22 +215,123 @@ private:
     friend class output_port<T>;
 
     auto add_data(std::tuple<buffer_type, timestamp_type>&& data) -> void {
-        const auto lock = std::scoped_lock{m_data_mtx};
-        if (m_queue.size() < m_depth) {
-            m_queue.emplace_back(std::move(data));
-            m_data_cv.notify_one();
+        using namespace std::chrono_literals;
+        const auto scope = profile_scope{m_enqueue_label.load(std::memory_order_acquire), "port"};
+        const auto& buffer = std::get<buffer_type>(data);
+        const auto bytes = (buffer != nullptr) ? traits::payload_bytes(*buffer) : std::size_t{0};
+        auto lock = std::unique_lock{m_data_mtx};
+        auto admitted = reserve(bytes);
+        if (!admitted && m_overflow == overflow_policy::BLOCK) {
+            // Wait for the consumer, or other ports sharing the budget, to free space
+            const auto timeout = clock_type::now() + WAIT_DURATION*1s;
+            while (!admitted && !m_eos && clock_type::now() < timeout) {
+                m_space_cv.wait_for(lock, BLOCK_POLL_PERIOD);
+                admitted = reserve(bytes);
+            }
+        }
+        if (!admitted) {
+            ++m_dropped;
+            return;
+        }
+        auto enqueued = (deadline().count() > 0) ? clock_type::now() : clock_type::time_point{};
+        m_queue.emplace_back(std::move(data), enqueued, bytes);
+        m_count.store(m_queue.size(), std::memory_order_release);
+        m_data_cv.notify_one();
+    }
+
+    // Claim room for a buffer of the given size, caller must hold m_data_mtx
+    auto reserve(std::size_t bytes) -> bool {
+        // max_bytes() may have been lowered below what is already queued
+        const auto max_bytes = m_max_bytes.load(std::memory_order_relaxed);
+        const auto queued = m_bytes.load(std::memory_order_relaxed);
+        if (m_queue.size() >= m_depth || queued >= max_bytes || bytes > max_bytes - queued) {
+            return false;
+        }
+        if (m_budget != nullptr && !m_budget->try_acquire(bytes)) {
+            return false;
         }
+        m_bytes += bytes;
+        return true;
     }
 
     auto eos(bool value) -> void {
         m_eos = value;
     }
 
-    std::deque<std::tuple<buffer_type, timestamp_type>> m_queue;
-    std::size_t m_depth{std::numeric_limits<std::size_t>::max()};
+    // Poll the queue without taking the lock until data arrives, end of
+    // stream is signaled or the time limit passes
+    auto spin(composite::wait_strategy strategy, std::chrono::nanoseconds limit) -> bool {
+        static constexpr int CLOCK_CHECK_INTERVAL{64};
+        const auto timeout = clock_type::now() + limit;
+        for (auto i = 0; ; ++i) {
+            if (m_count.load(std::memory_order_acquire) > 0 || m_eos) {
+                return true;
+            }
+            if (i % CLOCK_CHECK_INTERVAL == 0 && clock_type::now() >= timeout) {
+                return false;
+            }
+            if (strategy == composite::wait_strategy::YIELD) {
+                std::this_thread::yield();
+            } else {
+                cpu_relax();
+            }
+        }
+    }
+
+    // Marks the consumer as waiting for the lifetime of the scope
+    class waiting_scope {
+    public:
+        explicit waiting_scope(std::atomic_bool& flag) noexcept :
+          m_flag(flag) {
+            m_flag.store(true, std::memory_order_relaxed);
+        }
+
+        ~waiting_scope() {
+            m_flag.store(false, std::memory_order_relaxed);
+        }
+
+        waiting_scope(const waiting_scope&) = delete;
+        auto operator=(const waiting_scope&) -> waiting_scope& = delete;
+
+    private:
+        std::atomic_bool& m_flag;
+
+    }; // class waiting_scope
+
+    auto profile_label(std::string_view kind, std::string_view id) const -> std::string {
+        if (id.empty()) {
+            return std::string{kind} + " " + name();
+        }
+        return std::string{kind} + " " + std::string{id} + ":" + name();
+    }
+
+    using clock_type = std::chrono::steady_clock;
+
+    struct queue_entry {
+        std::tuple<buffer_type, timestamp_type> data;
+        clock_type::time_point enqueued;
+        std::size_t bytes;
+    };
+
+    std::deque<queue_entry> m_queue;
+    std::atomic<std::size_t> m_count{0}; // queue size, readable without the lock
+    std::atomic<composite::wait_strategy> m_wait_strategy{composite::wait_strategy::BLOCKING};
+    std::atomic<std::chrono::nanoseconds> m_spin_time{std::chrono::nanoseconds{0}};
+    std::atomic<std::size_t> m_depth{std::numeric_limits<std::size_t>::max()};
+    std::atomic<std::size_t> m_max_bytes{std::numeric_limits<std::size_t>::max()};
+    std::atomic<std::size_t> m_bytes{0};
+    std::atomic<uint64_t> m_dropped{0};
+    std::atomic<uint64_t> m_dequeued{0}; // written only by the consumer
+    std::atomic_bool m_waiting{false};
+    overflow_policy m_overflow{overflow_policy::DROP};
+    memory_budget* m_budget{nullptr};
     std::mutex m_data_mtx;
     std::condition_variable m_data_cv;
+    std::condition_variable m_space_cv;
     std::atomic_bool m_eos{false};
+    std::atomic<const char*> m_enqueue_label{nullptr};
+    std::atomic<const char*> m_dequeue_label{nullptr};
+    std::atomic<const char*> m_wait_label{nullptr};
 
 }; // class input_port
 
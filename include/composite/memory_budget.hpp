@@ -0,0 +1,68 @@
+/*
+ * Copyright (C) 2024 Geon Technologies, LLC
+ *
+ * This file is part of composite.
+ *
+ * composite is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * composite is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+
+namespace composite {
+
+// A pool of bytes shared by every input port queue in an application
+class memory_budget {
+public:
+    auto limit() const noexcept -> std::size_t {
+        return m_limit;
+    }
+
+    auto limit(std::size_t value) noexcept -> void {
+        m_limit = value;
+    }
+
+    auto used() const noexcept -> std::size_t {
+        return m_used;
+    }
+
+    auto try_acquire(std::size_t bytes) noexcept -> bool {
+        const auto limit = m_limit.load(std::memory_order_relaxed);
+        auto used = m_used.load(std::memory_order_relaxed);
+        do {
+            if (used > limit || bytes > limit - used) {
+                return false;
+            }
+        } while (!m_used.compare_exchange_weak(used, used + bytes, std::memory_order_relaxed));
+        return true;
+    }
+
+    auto acquire(std::size_t bytes) noexcept -> void {
+        m_used.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    auto release(std::size_t bytes) noexcept -> void {
+        m_used.fetch_sub(bytes, std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<std::size_t> m_limit{std::numeric_limits<std::size_t>::max()};
+    std::atomic<std::size_t> m_used{0};
+
+}; // class memory_budget
+
+} // namespace composite
@@ -23,9 +23,15 @@
 #include "input_port.hpp"
 #include "timestamp.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <ranges>
 #include <string_view>
+#include <thread>
 #include <typeinfo>
+#include <vector>
 
 namespace composite {
 
@@ -42,11 +48,20 @@ public:
         return typeid(T).hash_code();
     }
 
+    ~output_port() override {
+        delete m_connected_ports.load();
+    }
+
+    output_port(const output_port&) = delete;
+    auto operator=(const output_port&) -> output_port& = delete;
+
     auto send_data(buffer_type data, timestamp_type ts) -> void {
-        for (auto i : std::views::iota(size_t{0}, m_connected_ports.size())) {
-            if (auto port = m_connected_ports.at(i); port != nullptr) {
+        const auto guard = read_guard{m_readers};
+        const auto& ports = *m_connected_ports.load();
+        for (auto i : std::views::iota(size_t{0}, ports.size())) {
+            if (auto port = ports[i]; port != nullptr) {
                 if constexpr (traits::is_unique_ptr_v<T>) {
-                    if (i == m_connected_ports.size() - 1) {
+                    if (i == ports.size() - 1) {
                         // last port, move incoming
                         port->add_data({std::move(data), ts});
                     } else {
@@ -62,19 +77,53 @@ public:
     }
 
     auto connect(port* port) -> void override {
-        m_connected_ports.emplace_back(static_cast<input_port<T>*>(port));
+        connect(static_cast<input_port<T>*>(port));
+    }
+
+    auto connect(input_port<T>* port) -> void {
+        const auto lock = std::scoped_lock{m_connect_mtx};
+        auto ports = std::make_unique<connection_list>(*m_connected_ports.load());
+        // Keep higher priority ports first so they are served first
+        auto pos = std::ranges::find_if(*ports, [port](auto other) {
+            return other->priority() < port->priority();
+        });
+        ports->emplace(pos, port);
+        publish(std::move(ports));
+    }
+
+    // Senders may still be delivering to the port when this returns, call
+    // synchronize() before destroying it
+    auto disconnect(port* port) -> void override {
+        const auto lock = std::scoped_lock{m_connect_mtx};
+        const auto& current = *m_connected_ports.load();
+        if (std::ranges::find(current, port) == current.end()) {
+            return;
+        }
+        auto ports = std::make_unique<connection_list>(current);
+        std::erase(*ports, static_cast<input_port<T>*>(port));
+        publish(std::move(ports));
     }
 
     auto disconnect() -> void {
-        m_connected_ports.clear();
+        const auto lock = std::scoped_lock{m_connect_mtx};
+        publish(std::make_unique<connection_list>());
+    }
+
+    // Wait until no sender can still be using a connection list replaced
+    // before the call, so disconnected ports may be safely destroyed
+    auto synchronize() -> void override {
+        const auto lock = std::scoped_lock{m_connect_mtx};
+        reclaim(true);
     }
 
     auto is_connected() const -> bool {
-        return !m_connected_ports.empty();
+        const auto guard = read_guard{m_readers};
+        return !m_connected_ports.load()->empty();
     }
 
     void eos(bool value) const {
-        for (auto port : m_connected_ports) {
+        const auto guard = read_guard{m_readers};
+        for (auto port : *m_connected_ports.load()) {
             if (port) {
                 port->eos(value);
             }
@@ -82,7 +131,55 @@ public:
     }
 
 private:
-    std::vector<input_port<T>*> m_connected_ports;
+    using connection_list = std::vector<input_port<T>*>;
+
+    // Counts a sender in for as long as it may hold the connection list
+    class read_guard {
+    public:
+        explicit read_guard(std::atomic<std::size_t>& readers) noexcept :
+          m_readers(readers) {
+            m_readers.fetch_add(1);
+        }
+
+        ~read_guard() {
+            m_readers.fetch_sub(1, std::memory_order_release);
+        }
+
+        read_guard(const read_guard&) = delete;
+        auto operator=(const read_guard&) -> read_guard& = delete;
+
+    private:
+        std::atomic<std::size_t>& m_readers;
+
+    }; // class read_guard
+
+    // Swap in a new connection list and retire the previous one, caller
+    // must hold m_connect_mtx
+    auto publish(std::unique_ptr<const connection_list> ports) -> void {
+        m_retired.emplace_back(m_connected_ports.exchange(ports.release()));
+        reclaim(false);
+    }
+
+    // Free retired lists once no sender is active. Senders that arrive after
+    // a list was swapped out only see its replacement, so a single moment
+    // without senders ends the grace period of every list retired before it.
+    auto reclaim(bool wait) -> void {
+        if (m_retired.empty()) {
+            return;
+        }
+        while (m_readers.load() != 0) {
+            if (!wait) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+        m_retired.clear();
+    }
+
+    std::atomic<const connection_list*> m_connected_ports{new connection_list{}};
+    mutable std::atomic<std::size_t> m_readers{0};
+    std::vector<std::unique_ptr<const connection_list>> m_retired;
+    std::mutex m_connect_mtx;
 
 }; // class output_port
 
@@ -0,0 +1,98 @@
+/*
+ * Copyright (C) 2024 Geon Technologies, LLC
+ *
+ * This file is part of composite.
+ *
+ * composite is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * composite is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include "application.hpp"
+#include "component.hpp"
+#include "input_port.hpp"
+#include "lifecycle.hpp"
+#include "output_port.hpp"
+
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+
+namespace composite {
+
+// Connect an output port directly to an input port. The buffer types must
+// match at compile time, so no type_id check or virtual dispatch is needed.
+template <traits::smart_ptr T>
+auto connect(output_port<T>& output, input_port<T>& input) -> void {
+    output.connect(&input);
+}
+
+// A fixed set of components whose types and connections are known at build
+// time. Ports are addressed through member pointers rather than string names.
+template <std::derived_from<component>... Components>
+class pipeline : public lifecycle {
+public:
+    pipeline() :
+      m_components{std::make_shared<Components>()...} {
+    }
+
+    explicit pipeline(std::shared_ptr<Components>... components) :
+      m_components{std::move(components)...} {
+    }
+
+    template <std::size_t I>
+    auto get() const -> auto& {
+        return *std::get<I>(m_components);
+    }
+
+    template <typename C>
+    auto get() const -> C& {
+        return *std::get<std::shared_ptr<C>>(m_components);
+    }
+
+    template <std::size_t From, std::size_t To, typename Out, typename In, traits::smart_ptr T>
+    auto connect(output_port<T> Out::* output, input_port<T> In::* input) -> pipeline& {
+        static_assert(std::is_base_of_v<Out, std::remove_cvref_t<decltype(get<From>())>>,
+            "output port is not a member of the source component");
+        static_assert(std::is_base_of_v<In, std::remove_cvref_t<decltype(get<To>())>>,
+            "input port is not a member of the destination component");
+        composite::connect(get<From>().*output, get<To>().*input);
+        return *this;
+    }
+
+    auto initialize() -> void override {
+        std::apply([](auto&... comp) { (comp->initialize(), ...); }, m_components);
+    }
+
+    auto start() -> void override {
+        std::apply([](auto&... comp) { (comp->start(), ...); }, m_components);
+    }
+
+    auto stop() -> void override {
+        std::apply([](auto&... comp) { (comp->stop(), ...); }, m_components);
+    }
+
+    // Hand the components to an application so it drives their lifecycle
+    auto add_to(application& app) const -> void {
+        std::apply([&app](const auto&... comp) { (app.add_component(comp), ...); }, m_components);
+    }
+
+private:
+    std::tuple<std::shared_ptr<Components>...> m_components;
+
+}; // class pipeline
+
+} // namespace composite
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2024 Geon Technologies, LLC
+ *
+ * This file is part of composite.
+ *
+ * composite is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * composite is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include "component.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace composite {
+
+using create_function = std::shared_ptr<component> (*)();
+using create_with_arg_function = std::shared_ptr<component> (*)(std::string_view);
+
+// Named entry point for creating one type of component. Either create
+// function may be null if the component does not support that form.
+struct component_factory {
+    const char* name;
+    create_function create;
+    create_with_arg_function create_with_arg;
+}; // struct component_factory
+
+// Modules export their factories through a function with this signature,
+// named by FACTORY_TABLE_SYMBOL
+using factory_table_function = const component_factory* (*)(std::size_t*);
+inline constexpr const char* FACTORY_TABLE_SYMBOL{"composite_factories"};
+
+// Factories linked directly into the executable, which need no module lookup
+inline auto static_factories() -> std::vector<component_factory>& {
+    static auto factories = std::vector<component_factory>{};
+    return factories;
+}
+
+// Adds a factory to static_factories() during static initialization
+class static_registration {
+public:
+    explicit static_registration(component_factory factory) {
+        static_factories().emplace_back(factory);
+    }
+
+}; // class static_registration
+
+} // namespace composite
+
+// Define the factory table of a component module
+#define COMPOSITE_EXPORT_FACTORIES(...) \
+    extern "C" auto composite_factories(std::size_t* count) -> const composite::component_factory* { \
+        static const composite::component_factory factories[] = {__VA_ARGS__}; \
+        *count = sizeof(factories) / sizeof(factories[0]); \
+        return factories; \
+    }
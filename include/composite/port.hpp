@@ -19,8 +19,16 @@
  
 #pragma once
 
+#include "memory_budget.hpp"
+#include "wait_strategy.hpp"
+
+#include <atomic>
+#include <chrono>
 #include <concepts>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <ranges>
 #include <string>
 
 namespace composite {
@@ -40,8 +48,43 @@ template<typename T> constexpr bool is_unique_ptr_v = is_unique_ptr<T>::value;
 // concept for port types
 template<typename T> concept smart_ptr = is_shared_ptr_v<T> || is_unique_ptr_v<T>;
 
+// user-provided byte_size(const T&) overload, found by argument-dependent lookup
+template<typename T> concept has_byte_size = requires(const T& value) {
+    { byte_size(value) } -> std::convertible_to<std::size_t>;
+};
+
+// containers that allocate ahead of their size, such as std::vector
+template<typename T> concept has_capacity = requires(const T& value) {
+    { value.capacity() } -> std::convertible_to<std::size_t>;
+};
+
+// bytes of memory held by a buffer's payload, counting allocated rather
+// than used elements
+template<typename T>
+auto payload_bytes(const T& value) -> std::size_t {
+    if constexpr (has_byte_size<T>) {
+        return byte_size(value);
+    } else if constexpr (std::ranges::contiguous_range<T> && has_capacity<T>) {
+        return sizeof(T) + value.capacity() * sizeof(std::ranges::range_value_t<T>);
+    } else if constexpr (std::ranges::contiguous_range<T> && std::ranges::sized_range<T>) {
+        return sizeof(T) + std::ranges::size(value) * sizeof(std::ranges::range_value_t<T>);
+    } else {
+        return sizeof(T);
+    }
+}
+
 } // namespace traits
-    
+
+// While a component with a deadline runs process(), points at the time its
+// first input was dequeued, which input ports fill in
+inline thread_local std::chrono::steady_clock::time_point* process_dequeue_time{nullptr};
+
+// What an input port does with incoming data when its queue is full
+enum class overflow_policy : int {
+    DROP,
+    BLOCK
+}; // enum class overflow_policy
+
 
 class port {
 public:
@@ -51,18 +94,104 @@ public:
 
     virtual ~port() = default;
 
-    auto name() const noexcept -> std::string {
+    auto name() const noexcept -> const std::string& {
         return m_name;
     }
 
     virtual auto type_id() const noexcept -> std::size_t = 0;
 
+    auto priority() const noexcept -> int {
+        return m_priority;
+    }
+
+    auto priority(int value) noexcept -> void {
+        m_priority = value;
+    }
+
+    auto deadline() const noexcept -> std::chrono::nanoseconds {
+        return m_deadline;
+    }
+
+    auto deadline(std::chrono::nanoseconds value) noexcept -> void {
+        m_deadline = value;
+    }
+
+    auto deadline_misses() const noexcept -> uint64_t {
+        return m_deadline_misses;
+    }
+
     virtual auto connect(port* port) -> void {
         // to be implemented by derived class
     }
 
+    virtual auto disconnect(port* /*port*/) -> void {
+        // to be implemented by derived class
+    }
+
+    // Wait until data no longer reaches ports disconnected from this one
+    virtual auto synchronize() -> void {
+        // to be implemented by derived class
+    }
+
+    // Id of the component owning the port, set when the port is added
+    virtual auto component_id(std::string_view /*id*/) -> void {
+        // to be implemented by derived class
+    }
+
+    virtual auto depth(std::size_t /*value*/) -> void {
+        // to be implemented by derived class
+    }
+
+    virtual auto max_bytes(std::size_t /*value*/) -> void {
+        // to be implemented by derived class
+    }
+
+    virtual auto overflow(overflow_policy /*value*/) -> void {
+        // to be implemented by derived class
+    }
+
+    virtual auto budget(memory_budget* /*value*/) -> void {
+        // to be implemented by derived class
+    }
+
+    virtual auto wait_strategy(composite::wait_strategy /*value*/, std::chrono::nanoseconds /*spin_time*/) -> void {
+        // to be implemented by derived class
+    }
+
+    virtual auto bytes() const noexcept -> std::size_t {
+        return 0;
+    }
+
+    virtual auto dropped() const noexcept -> uint64_t {
+        return 0;
+    }
+
+    // Buffers waiting in the queue, read without locking
+    virtual auto queued() const noexcept -> std::size_t {
+        return 0;
+    }
+
+    // Progress indicators sampled by the watchdog
+
+    virtual auto dequeued() const noexcept -> uint64_t {
+        return 0;
+    }
+
+    virtual auto full() const noexcept -> bool {
+        return false;
+    }
+
+    virtual auto waiting() const noexcept -> bool {
+        return false;
+    }
+
+protected:
+    std::atomic<uint64_t> m_deadline_misses{0};
+
 private:
     std::string m_name;
+    int m_priority{0};
+    std::chrono::nanoseconds m_deadline{0};
 
 }; // class port
 
@@ -21,27 +21,68 @@
 
 #include "port.hpp"
 
+#include <algorithm>
+#include <cstddef>
 #include <map>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace composite {
 
 class port_set {
-    using port_map_t = std::map<std::string, port*>;
+    using port_map_t = std::map<std::string, port*, std::less<>>;
 public:
     auto add_port(port* port) -> void {
-        m_ports.try_emplace(port->name(), port);
+        if (m_ports.try_emplace(port->name(), port).second) {
+            m_indexed.emplace_back(port);
+        }
     }
 
     auto get_port(std::string_view name) -> port* {
-        if (m_ports.contains(std::string{name})) {
-            return m_ports.at(std::string{name});
+        auto iter = m_ports.find(name);
+        return (iter != m_ports.end()) ? iter->second : nullptr;
+    }
+
+    // Ports in the order they were added, so a resolved index stays valid for
+    // every instance of a component type
+    auto port_at(std::size_t index) const -> port* {
+        return (index < m_indexed.size()) ? m_indexed[index] : nullptr;
+    }
+
+    auto port_index(std::string_view name) const -> std::optional<std::size_t> {
+        auto iter = std::ranges::find_if(m_indexed, [name](auto port) { return port->name() == name; });
+        if (iter == m_indexed.end()) {
+            return std::nullopt;
+        }
+        return static_cast<std::size_t>(iter - m_indexed.begin());
+    }
+
+    // The port with the highest priority that has data queued, the earliest
+    // added among equals, or nullptr if none has
+    auto next_queued() const noexcept -> port* {
+        auto retval = static_cast<port*>(nullptr);
+        for (auto port : m_indexed) {
+            if ((retval == nullptr || port->priority() > retval->priority()) && port->queued() > 0) {
+                retval = port;
+            }
+        }
+        return retval;
+    }
+
+    auto ports() const -> std::vector<port*> {
+        auto retval = std::vector<port*>{};
+        retval.reserve(m_ports.size());
+        for (const auto& [name, port] : m_ports) {
+            retval.emplace_back(port);
         }
-        return nullptr;
+        return retval;
     }
 
 private:
     port_map_t m_ports;
+    std::vector<port*> m_indexed;
 
 }; // class port_set
 
@@ -0,0 +1,230 @@
+/*
+ * Copyright (C) 2024 Geon Technologies, LLC
+ *
+ * This file is part of composite.
+ *
+ * composite is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * composite is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace composite {
+
+// Records timestamped spans into per-thread ring buffers and exports them in
+// the Chrome trace event format. Each buffer has a single writer, so recording
+// never takes a lock; when disabled, a span costs one relaxed atomic load.
+// Once a buffer is full the oldest events are overwritten, so the trace always
+// holds the most recent activity of each thread.
+class profiler {
+public:
+    static constexpr std::size_t DEFAULT_CAPACITY{1 << 16}; // events per thread
+
+    struct event {
+        const char* name;
+        const char* category;
+        uint64_t begin; // nanoseconds
+        uint64_t duration; // nanoseconds
+    };
+
+    static auto instance() -> profiler& {
+        static auto instance = profiler{};
+        return instance;
+    }
+
+    static auto now() noexcept -> uint64_t {
+        auto since_epoch = std::chrono::steady_clock::now().time_since_epoch();
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(since_epoch).count());
+    }
+
+    auto enabled() const noexcept -> bool {
+        return m_enabled.load(std::memory_order_relaxed);
+    }
+
+    auto enable(bool value) noexcept -> void {
+        m_enabled.store(value, std::memory_order_relaxed);
+    }
+
+    auto toggle() noexcept -> bool {
+        auto value = m_enabled.load(std::memory_order_relaxed);
+        while (!m_enabled.compare_exchange_weak(value, !value, std::memory_order_relaxed)) {}
+        return !value;
+    }
+
+    auto capacity() const noexcept -> std::size_t {
+        return m_capacity.load(std::memory_order_relaxed);
+    }
+
+    // Events kept per thread, rounded up to a power of two. Applies to threads
+    // that have not recorded yet, so set it before recording starts.
+    auto capacity(std::size_t value) noexcept -> void {
+        m_capacity.store(std::bit_ceil(std::max(value, std::size_t{1})), std::memory_order_relaxed);
+    }
+
+    // Name the calling thread in the exported trace
+    auto thread_name(std::string_view name) -> void {
+        auto buffer = local_buffer();
+        const auto lock = std::scoped_lock{m_mtx};
+        buffer->name = name;
+    }
+
+    // Return a pointer to a copy of the string that lives as long as the profiler
+    auto intern(std::string_view str) -> const char* {
+        const auto lock = std::scoped_lock{m_mtx};
+        return m_strings.emplace(str).first->c_str();
+    }
+
+    auto record(const char* name, const char* category, uint64_t begin, uint64_t end) -> void {
+        auto buffer = local_buffer();
+        if (!buffer->events) {
+            buffer->capacity = capacity();
+            buffer->events = std::make_unique<event[]>(buffer->capacity);
+        }
+        auto head = buffer->head.load(std::memory_order_relaxed);
+        buffer->events[head & (buffer->capacity - 1)] = event{name, category, begin, end - begin};
+        buffer->head.store(head + 1, std::memory_order_release);
+    }
+
+    // Events lost to newer ones across all threads
+    auto overwritten() const -> uint64_t {
+        const auto lock = std::scoped_lock{m_mtx};
+        auto retval = uint64_t{};
+        for (const auto& buffer : m_buffers) {
+            auto head = buffer->head.load(std::memory_order_acquire);
+            if (head > 0 && head > buffer->capacity) {
+                retval += head - buffer->capacity;
+            }
+        }
+        return retval;
+    }
+
+    // Threads keep recording into their buffers while enabled, so pause
+    // recording first for a consistent trace
+    auto write_trace(std::ostream& os) const -> void {
+        const auto lock = std::scoped_lock{m_mtx};
+        auto first = true;
+        auto separator = [&os, &first] {
+            os << (first ? "\n" : ",\n");
+            first = false;
+        };
+        os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        for (const auto& buffer : m_buffers) {
+            if (!buffer->name.empty()) {
+                separator();
+                os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->tid
+                   << ",\"args\":{\"name\":\"" << escape(buffer->name) << "\"}}";
+            }
+            // capacity is only safe to read once the thread has recorded
+            auto head = buffer->head.load(std::memory_order_acquire);
+            auto oldest = (head > 0 && head > buffer->capacity) ? head - buffer->capacity : 0;
+            for (auto i = oldest; i < head; ++i) {
+                const auto& evt = buffer->events[i & (buffer->capacity - 1)];
+                separator();
+                os << "{\"name\":\"" << escape(evt.name) << "\",\"cat\":\"" << evt.category
+                   << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->tid
+                   << ",\"ts\":" << (evt.begin / 1000) << '.' << pad(evt.begin % 1000)
+                   << ",\"dur\":" << (evt.duration / 1000) << '.' << pad(evt.duration % 1000) << '}';
+            }
+        }
+        os << "\n]}\n";
+    }
+
+private:
+    struct thread_buffer {
+        uint32_t tid{};
+        std::string name;
+        std::unique_ptr<event[]> events;
+        std::size_t capacity{0};
+        std::atomic<uint64_t> head{0}; // events ever recorded
+    };
+
+    profiler() = default;
+
+    auto local_buffer() -> thread_buffer* {
+        thread_local auto buffer = register_thread();
+        return buffer;
+    }
+
+    auto register_thread() -> thread_buffer* {
+        const auto lock = std::scoped_lock{m_mtx};
+        auto& buffer = m_buffers.emplace_back(std::make_unique<thread_buffer>());
+        buffer->tid = static_cast<uint32_t>(m_buffers.size());
+        return buffer.get();
+    }
+
+    static auto pad(uint64_t value) -> std::string {
+        auto retval = std::to_string(value);
+        return std::string(3 - retval.size(), '0') + retval;
+    }
+
+    static auto escape(std::string_view str) -> std::string {
+        auto retval = std::string{};
+        retval.reserve(str.size());
+        for (auto c : str) {
+            if (c == '"' || c == '\\') {
+                retval += '\\';
+            }
+            if (static_cast<unsigned char>(c) >= 0x20) {
+                retval += c;
+            }
+        }
+        return retval;
+    }
+
+    std::atomic_bool m_enabled{false};
+    std::atomic<std::size_t> m_capacity{DEFAULT_CAPACITY};
+    mutable std::mutex m_mtx;
+    std::vector<std::unique_ptr<thread_buffer>> m_buffers;
+    std::set<std::string, std::less<>> m_strings;
+
+}; // class profiler
+
+// Records the lifetime of the scope as a span when profiling is enabled
+class profile_scope {
+public:
+    profile_scope(const char* name, const char* category) :
+      m_name(name),
+      m_category(category),
+      m_begin(profiler::instance().enabled() ? profiler::now() : 0) {
+    }
+
+    profile_scope(const profile_scope&) = delete;
+    auto operator=(const profile_scope&) -> profile_scope& = delete;
+
+    ~profile_scope() {
+        if (m_begin != 0) {
+            profiler::instance().record(m_name, m_category, m_begin, profiler::now());
+        }
+    }
+
+private:
+    const char* m_name;
+    const char* m_category;
+    uint64_t m_begin;
+
+}; // class profile_scope
+
+} // namespace composite
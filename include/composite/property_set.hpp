@@ -20,7 +20,9 @@
 #pragma once
 
 #include <any>
+#include <functional>
 #include <map>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 
@@ -33,21 +35,29 @@ public:
         m_properties.try_emplace(std::string{name}, prop);
     }
 
+    auto has_property(std::string_view name) const -> bool {
+        return m_properties.contains(name);
+    }
+
     template <typename T>
     auto set_property(std::string_view name, T value) -> void {
-        if (m_properties.contains(std::string{name})) {
-            *(*std::any_cast<T*>(&(m_properties.at(std::string{name})))) = value;
+        if (auto iter = m_properties.find(name); iter != m_properties.end()) {
+            *(*std::any_cast<T*>(&iter->second)) = value;
         }
     }
 
     template <typename T>
     auto get_property(std::string_view name) const -> T
     {
-        return *std::any_cast<T*>(m_properties.at(std::string{name}));
+        auto iter = m_properties.find(name);
+        if (iter == m_properties.end()) {
+            throw std::out_of_range("no property named " + std::string{name});
+        }
+        return *std::any_cast<T*>(iter->second);
     }
 
 private:
-    std::map<std::string, std::any> m_properties;
+    std::map<std::string, std::any, std::less<>> m_properties;
 
 }; // class property_set
 
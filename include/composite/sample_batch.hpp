@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2024 Geon Technologies, LLC
+ *
+ * This file is part of composite.
+ *
+ * composite is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * composite is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include "timestamp.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace composite {
+
+inline constexpr int64_t NS_PER_SECOND{1000000000};
+inline constexpr uint64_t PS_PER_NS{1000};
+
+inline auto to_nanoseconds(const timestamp& ts) noexcept -> int64_t {
+    return static_cast<int64_t>(ts.seconds) * NS_PER_SECOND + static_cast<int64_t>(ts.picoseconds / PS_PER_NS);
+}
+
+// Times before zero round down to the previous whole second, so picoseconds
+// always stay within a second; the seconds wrap like any unsigned value
+inline auto to_timestamp(int64_t ns) noexcept -> timestamp {
+    auto seconds = ns / NS_PER_SECOND;
+    auto remainder = ns % NS_PER_SECOND;
+    if (remainder < 0) {
+        --seconds;
+        remainder += NS_PER_SECOND;
+    }
+    return timestamp{
+        static_cast<uint32_t>(seconds),
+        static_cast<uint64_t>(remainder) * PS_PER_NS
+    };
+}
+
+// Convert a run of timestamps, out must hold at least in.size() elements
+inline auto to_nanoseconds(std::span<const timestamp> in, std::span<int64_t> out) noexcept -> void {
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        out[i] = to_nanoseconds(in[i]);
+    }
+}
+
+inline auto to_timestamps(std::span<const int64_t> in, std::span<timestamp> out) noexcept -> void {
+    for (std::size_t i = 0; i < in.size(); ++i) {
+        out[i] = to_timestamp(in[i]);
+    }
+}
+
+// Allocator returning storage aligned for the widest vector registers
+template <typename T, std::size_t Alignment>
+class aligned_allocator {
+public:
+    using value_type = T;
+
+    template <typename U>
+    struct rebind {
+        using other = aligned_allocator<U, Alignment>;
+    };
+
+    aligned_allocator() noexcept = default;
+
+    template <typename U>
+    aligned_allocator(const aligned_allocator<U, Alignment>& /*other*/) noexcept {
+    }
+
+    auto allocate(std::size_t count) -> T* {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t{Alignment}));
+    }
+
+    auto deallocate(T* ptr, std::size_t /*count*/) noexcept -> void {
+        ::operator delete(ptr, std::align_val_t{Alignment});
+    }
+
+    template <typename U>
+    auto operator==(const aligned_allocator<U, Alignment>& /*other*/) const noexcept -> bool {
+        return true;
+    }
+
+}; // class aligned_allocator
+
+// A batch of timestamped samples stored as two aligned columns, one of
+// values and one of integer nanosecond times, so a whole batch travels
+// through a port as a single buffer and the helpers below compile to
+// vectorized loops. Times are expected to be non-decreasing.
+template <typename T>
+class sample_batch {
+    static_assert(std::is_trivially_copyable_v<T>, "sample values must be trivially copyable");
+
+public:
+    static constexpr std::size_t ALIGNMENT{64};
+
+    using value_type = T;
+    using value_column = std::vector<T, aligned_allocator<T, ALIGNMENT>>;
+    using time_column = std::vector<int64_t, aligned_allocator<int64_t, ALIGNMENT>>;
+
+    sample_batch() = default;
+
+    explicit sample_batch(std::size_t capacity) {
+        reserve(capacity);
+    }
+
+    auto size() const noexcept -> std::size_t {
+        return m_values.size();
+    }
+
+    auto empty() const noexcept -> bool {
+        return m_values.empty();
+    }
+
+    auto capacity() const noexcept -> std::size_t {
+        return std::min(m_values.capacity(), m_times.capacity());
+    }
+
+    auto reserve(std::size_t count) -> void {
+        m_values.reserve(count);
+        m_times.reserve(count);
+    }
+
+    auto resize(std::size_t count) -> void {
+        m_values.resize(count);
+        m_times.resize(count);
+    }
+
+    auto clear() noexcept -> void {
+        m_values.clear();
+        m_times.clear();
+    }
+
+    auto push_back(T value, int64_t time_ns) -> void {
+        m_values.emplace_back(value);
+        m_times.emplace_back(time_ns);
+    }
+
+    auto push_back(T value, const timestamp& ts) -> void {
+        push_back(value, to_nanoseconds(ts));
+    }
+
+    auto values() noexcept -> std::span<T> {
+        return m_values;
+    }
+
+    auto values() const noexcept -> std::span<const T> {
+        return m_values;
+    }
+
+    // Sample times in nanoseconds
+    auto times() noexcept -> std::span<int64_t> {
+        return m_times;
+    }
+
+    auto times() const noexcept -> std::span<const int64_t> {
+        return m_times;
+    }
+
+    auto time(std::size_t index) const -> timestamp {
+        return to_timestamp(m_times[index]);
+    }
+
+    // Index range [first, last) of the samples with begin_ns <= time < end_ns
+    auto window(int64_t begin_ns, int64_t end_ns) const -> std::pair<std::size_t, std::size_t> {
+        auto first = std::ranges::lower_bound(m_times, begin_ns);
+        auto last = std::ranges::lower_bound(first, m_times.end(), end_ns);
+        return {
+            static_cast<std::size_t>(first - m_times.begin()),
+            static_cast<std::size_t>(last - m_times.begin())
+        };
+    }
+
+    // Copy of the samples with begin_ns <= time < end_ns
+    auto slice(int64_t begin_ns, int64_t end_ns) const -> sample_batch {
+        auto [first, last] = window(begin_ns, end_ns);
+        auto batch = sample_batch{};
+        batch.m_values.assign(m_values.begin() + first, m_values.begin() + last);
+        batch.m_times.assign(m_times.begin() + first, m_times.begin() + last);
+        return batch;
+    }
+
+    // value = value * gain + offset for every sample
+    auto scale(T gain, T offset = T{}) noexcept -> void {
+        auto* __restrict values = std::assume_aligned<ALIGNMENT>(m_values.data());
+        const auto count = m_values.size();
+        for (std::size_t i = 0; i < count; ++i) {
+            values[i] = values[i] * gain + offset;
+        }
+    }
+
+    // Move every sample time by delta_ns
+    auto shift(int64_t delta_ns) noexcept -> void {
+        auto* __restrict times = std::assume_aligned<ALIGNMENT>(m_times.data());
+        const auto count = m_times.size();
+        for (std::size_t i = 0; i < count; ++i) {
+            times[i] += delta_ns;
+        }
+    }
+
+    // Bytes held by a batch, found by traits::payload_bytes for port byte limits
+    friend auto byte_size(const sample_batch& batch) noexcept -> std::size_t {
+        return sizeof(batch) + batch.m_values.capacity() * sizeof(T) + batch.m_times.capacity() * sizeof(int64_t);
+    }
+
+private:
+    value_column m_values;
+    time_column m_times;
+
+}; // class sample_batch
+
+} // namespace composite
@@ -0,0 +1,57 @@
+/*
+ * Copyright (C) 2024 Geon Technologies, LLC
+ *
+ * This file is part of composite.
+ *
+ * composite is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * composite is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <optional>
+#include <string_view>
+
+namespace composite {
+
+// How an input port waits for data to arrive
+enum class wait_strategy : int {
+    BLOCKING, // park on a condition variable
+    SPIN,     // busy-spin with a CPU pause hint
+    YIELD,    // spin, yielding the CPU between checks
+    HYBRID    // spin for a bounded time, then park
+}; // enum class wait_strategy
+
+inline auto to_wait_strategy(std::string_view name) -> std::optional<wait_strategy> {
+    if (name == "blocking") {
+        return wait_strategy::BLOCKING;
+    } else if (name == "spin") {
+        return wait_strategy::SPIN;
+    } else if (name == "yield") {
+        return wait_strategy::YIELD;
+    } else if (name == "hybrid") {
+        return wait_strategy::HYBRID;
+    }
+    return std::nullopt;
+}
+
+// Hint to the CPU that the caller is in a spin-wait loop
+inline auto cpu_relax() noexcept -> void {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield");
+#endif
+}
+
+} // namespace composite
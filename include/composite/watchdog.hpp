@@ -0,0 +1,227 @@
+/*
+ * Copyright (C) 2024 Geon Technologies, LLC
+ *
+ * This file is part of composite.
+ *
+ * composite is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * composite is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include "component.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace composite {
+
+enum class watchdog_event_type : int {
+    STALLED_PROCESS, // process() has not returned within the limit
+    STALLED_QUEUE,   // an input queue is full and nothing is being dequeued
+    STARVED          // process() keeps returning NOOP while an input is full
+}; // enum class watchdog_event_type
+
+inline auto to_string(watchdog_event_type type) -> std::string_view {
+    switch (type) {
+        case watchdog_event_type::STALLED_PROCESS:
+            return "stalled process";
+        case watchdog_event_type::STALLED_QUEUE:
+            return "stalled queue";
+        case watchdog_event_type::STARVED:
+            return "starved";
+    }
+    return "unknown";
+}
+
+struct watchdog_event {
+    watchdog_event_type type;
+    std::string component; // component id
+    std::string port;      // empty unless the event concerns a single port
+    std::chrono::nanoseconds duration;
+}; // struct watchdog_event
+
+// Periodically samples component heartbeats and port progress counters from
+// its own thread, reporting each stall once when it has lasted longer than
+// the limit. Nothing on the data path waits on the watchdog.
+class watchdog {
+    using clock_type = std::chrono::steady_clock;
+
+public:
+    using component_ptr = std::shared_ptr<component>;
+    using source_type = std::function<std::vector<component_ptr>()>;
+    using callback_type = std::function<void(const watchdog_event&)>;
+
+    watchdog(
+      source_type source,
+      std::chrono::nanoseconds period,
+      std::chrono::nanoseconds limit,
+      callback_type callback
+    ) :
+      m_source(std::move(source)),
+      m_period(period),
+      m_limit(limit),
+      m_callback(std::move(callback)) {
+    }
+
+    ~watchdog() {
+        stop();
+    }
+
+    watchdog(const watchdog&) = delete;
+    auto operator=(const watchdog&) -> watchdog& = delete;
+
+    auto period() const noexcept -> std::chrono::nanoseconds {
+        return m_period;
+    }
+
+    auto limit() const noexcept -> std::chrono::nanoseconds {
+        return m_limit;
+    }
+
+    auto start() -> void {
+        if (m_thread.joinable()) {
+            return;
+        }
+        m_thread = std::jthread([this](std::stop_token token) {
+            thread_func(token);
+        });
+    }
+
+    auto stop() -> void {
+        m_thread.request_stop();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+        m_thread = std::jthread{};
+    }
+
+    // Sample every component once, normally called from the watchdog thread
+    auto check() -> void {
+        const auto now = clock_type::now();
+        auto components = std::map<const component*, component_state>{};
+        auto ports = std::map<const port*, port_state>{};
+        for (const auto& comp : m_source()) {
+            auto comp_state = take(m_components, comp.get());
+            const auto comp_ports = comp->ports();
+            auto waiting = false;
+            auto full = false;
+            for (auto port : comp_ports) {
+                auto port_state = take(m_ports, port);
+                const auto port_full = port->full();
+                const auto dequeued = port->dequeued();
+                if (auto duration = port_state.stalled.update(port_full && dequeued == port_state.dequeued, now, m_limit)) {
+                    m_callback({watchdog_event_type::STALLED_QUEUE, comp->id(), port->name(), *duration});
+                }
+                port_state.dequeued = dequeued;
+                ports.emplace(port, port_state);
+                waiting = waiting || port->waiting();
+                full = full || port_full;
+            }
+
+            // A component waiting on an empty input is idle, not stuck
+            const auto heartbeat = comp->heartbeat();
+            const auto stuck = comp->processing() && !waiting && heartbeat == comp_state.heartbeat;
+            if (auto duration = comp_state.stalled.update(stuck, now, m_limit)) {
+                m_callback({watchdog_event_type::STALLED_PROCESS, comp->id(), {}, *duration});
+            }
+            const auto starved = comp->last_result() == retval::NOOP && full;
+            if (auto duration = comp_state.starved.update(starved, now, m_limit)) {
+                m_callback({watchdog_event_type::STARVED, comp->id(), {}, *duration});
+            }
+            comp_state.heartbeat = heartbeat;
+            components.emplace(comp.get(), comp_state);
+        }
+        // Dropping the old maps forgets components removed since the last check
+        m_components = std::move(components);
+        m_ports = std::move(ports);
+    }
+
+private:
+    // Tracks how long a sampled condition has held without interruption
+    struct condition {
+        clock_type::time_point since{};
+        bool active{false};
+        bool reported{false};
+
+        // Returns the duration once, when the condition first exceeds the limit
+        auto update(bool holds, clock_type::time_point now, std::chrono::nanoseconds limit) -> std::optional<std::chrono::nanoseconds> {
+            if (!holds) {
+                active = false;
+                reported = false;
+                return std::nullopt;
+            }
+            if (!active) {
+                active = true;
+                since = now;
+            }
+            if (reported || now - since < limit) {
+                return std::nullopt;
+            }
+            reported = true;
+            return now - since;
+        }
+    }; // struct condition
+
+    struct component_state {
+        uint64_t heartbeat{0};
+        condition stalled;
+        condition starved;
+    }; // struct component_state
+
+    struct port_state {
+        uint64_t dequeued{0};
+        condition stalled;
+    }; // struct port_state
+
+    template <typename Key, typename State>
+    static auto take(std::map<const Key*, State>& states, const Key* key) -> State {
+        auto node = states.extract(key);
+        return node.empty() ? State{} : std::move(node.mapped());
+    }
+
+    auto thread_func(std::stop_token token) -> void {
+        auto mtx = std::mutex{};
+        auto cv = std::condition_variable_any{};
+        auto lock = std::unique_lock{mtx};
+        while (!cv.wait_for(lock, token, m_period, [] { return false; })) {
+            if (token.stop_requested()) {
+                break;
+            }
+            check();
+        }
+    }
+
+    source_type m_source;
+    std::chrono::nanoseconds m_period;
+    std::chrono::nanoseconds m_limit;
+    callback_type m_callback;
+    std::map<const component*, component_state> m_components;
+    std::map<const port*, port_state> m_ports;
+    std::jthread m_thread;
+
+}; // class watchdog
+
+} // namespace composite
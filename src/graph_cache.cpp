@@ -0,0 +1,625 @@
+/*
+ * Copyright (C) 2024 Geon Technologies, LLC
+ *
+ * This file is part of composite.
+ *
+ * composite is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * composite is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+ 
+ 
+#include "graph_cache.hpp"
+
+#include "composite/port.hpp"
+#include "composite/version.hpp"
+#include "composite/wait_strategy.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fmt/core.h>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <numeric>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
+
+namespace {
+
+constexpr std::array<char, 8> MAGIC{'C', 'O', 'M', 'P', 'G', 'R', 'P', 'H'};
+constexpr uint32_t FORMAT_VERSION{3};
+constexpr uint32_t ENDIAN_MARKER{0x01020304};
+constexpr std::size_t RECORD_ALIGNMENT{8};
+
+auto align(std::size_t offset) -> std::size_t {
+    return (offset + RECORD_ALIGNMENT - 1) / RECORD_ALIGNMENT * RECORD_ALIGNMENT;
+}
+
+auto build_version() -> std::array<char, 16> {
+    static_assert(sizeof(VERSION) <= 16, "version string does not fit the graph cache header");
+    auto retval = std::array<char, 16>{};
+    std::ranges::copy(std::string_view{VERSION}, retval.begin());
+    return retval;
+}
+
+auto to_property_type(std::string_view type) -> std::optional<graph_cache::property_type> {
+    using enum graph_cache::property_type;
+    if (type == "bool") {
+        return BOOL;
+    } else if (type == "string") {
+        return STRING;
+    } else if (type == "int32") {
+        return INT32;
+    } else if (type == "uint32") {
+        return UINT32;
+    } else if (type == "int64") {
+        return INT64;
+    } else if (type == "uint64") {
+        return UINT64;
+    } else if (type == "float") {
+        return FLOAT;
+    } else if (type == "double") {
+        return DOUBLE;
+    }
+    return std::nullopt;
+}
+
+auto to_wait_strategy(const nlohmann::json& json) -> uint32_t {
+    auto name = json["wait_strategy"].get<std::string>();
+    auto strategy = composite::to_wait_strategy(name);
+    if (!strategy) {
+        throw std::runtime_error(fmt::format("invalid wait strategy '{}'", name));
+    }
+    return static_cast<uint32_t>(*strategy);
+}
+
+} // namespace
+
+// Accumulates records and interned strings, then lays them out in one image
+class graph_cache::builder {
+public:
+    auto intern(std::string_view value) -> string_ref {
+        if (auto iter = m_interned.find(value); iter != m_interned.end()) {
+            return iter->second;
+        }
+        if (m_strings.size() + value.size() > std::numeric_limits<uint32_t>::max()) {
+            throw std::runtime_error("graph string table too large");
+        }
+        auto ref = string_ref{static_cast<uint32_t>(m_strings.size()), static_cast<uint32_t>(value.size())};
+        m_strings.append(value);
+        m_interned.emplace(std::string{value}, ref);
+        return ref;
+    }
+
+    auto add_property(const nlohmann::json& prop) -> void {
+        auto type_name = prop.at("type").get<std::string>();
+        auto type = to_property_type(type_name);
+        if (!type) {
+            throw std::runtime_error(fmt::format("unknown type '{}' for property: {}", type_name, prop.dump()));
+        }
+        auto record = property_record{intern(prop.at("name").get<std::string>()), *type, 0, 0};
+        const auto& value = prop.at("value");
+        switch (*type) {
+            case property_type::BOOL:
+                record.bits = value.get<bool>() ? 1 : 0;
+                break;
+            case property_type::STRING: {
+                auto ref = intern(value.get<std::string>());
+                record.bits = (uint64_t{ref.offset} << 32U) | ref.size;
+                break;
+            }
+            case property_type::INT32:
+                record.bits = std::bit_cast<uint64_t>(int64_t{value.get<int32_t>()});
+                break;
+            case property_type::UINT32:
+                record.bits = value.get<uint32_t>();
+                break;
+            case property_type::INT64:
+                record.bits = std::bit_cast<uint64_t>(value.get<int64_t>());
+                break;
+            case property_type::UINT64:
+                record.bits = value.get<uint64_t>();
+                break;
+            case property_type::FLOAT:
+            case property_type::DOUBLE:
+                record.bits = std::bit_cast<uint64_t>(value.get<double>());
+                break;
+        }
+        m_properties.emplace_back(record);
+    }
+
+    auto add_component(const nlohmann::json& comp) -> void {
+        auto record = component_record{};
+        record.name = intern(comp.at("name").get<std::string>());
+        if (comp.contains("id")) {
+            record.flags |= HAS_ID;
+            record.id = intern(comp["id"].get<std::string>());
+        }
+        if (comp.contains("module")) {
+            record.flags |= HAS_MODULE;
+            record.module = intern(comp["module"].get<std::string>());
+        }
+        if (comp.contains("create_arg")) {
+            record.flags |= HAS_CREATE_ARG;
+            record.create_arg = intern(comp["create_arg"].get<std::string>());
+        }
+        if (comp.contains("priority")) {
+            record.flags |= HAS_PRIORITY;
+            record.priority = comp["priority"].get<int32_t>();
+        }
+        if (comp.contains("deadline_us")) {
+            record.flags |= HAS_DEADLINE;
+            record.deadline_us = comp["deadline_us"].get<int64_t>();
+        }
+        if (comp.contains("wait_strategy")) {
+            record.flags |= HAS_WAIT_STRATEGY;
+            record.wait_strategy = to_wait_strategy(comp);
+            record.spin_ns = comp.value("spin_ns", int64_t{0});
+        }
+        record.first_property = static_cast<uint32_t>(m_properties.size());
+        if (comp.contains("properties")) {
+            for (const auto& prop : comp["properties"]) {
+                add_property(prop);
+            }
+        }
+        record.property_count = static_cast<uint32_t>(m_properties.size()) - record.first_property;
+        m_components.emplace_back(record);
+    }
+
+    auto add_connection(const nlohmann::json& conn) -> void {
+        if (!conn.contains("output")) {
+            throw std::runtime_error(fmt::format("missing output for connection: {}", conn.dump()));
+        }
+        if (!conn.contains("input")) {
+            throw std::runtime_error(fmt::format("missing input for connection: {}", conn.dump()));
+        }
+        const auto& output = conn["output"];
+        const auto& input = conn["input"];
+        for (const auto& [endpoint, side] : {std::pair{&output, "output"}, std::pair{&input, "input"}}) {
+            if (!endpoint->contains("component")) {
+                throw std::runtime_error(fmt::format("missing component in connection {}: {}", side, conn.dump()));
+            }
+            if (!endpoint->contains("port")) {
+                throw std::runtime_error(fmt::format("missing port in connection {}: {}", side, conn.dump()));
+            }
+        }
+        auto record = connection_record{};
+        record.output_component = intern(output["component"].get<std::string>());
+        record.input_component = intern(input["component"].get<std::string>());
+        record.output_port = intern(output["port"].get<std::string>());
+        record.input_port = intern(input["port"].get<std::string>());
+        record.output_component_index = UNRESOLVED;
+        record.input_component_index = UNRESOLVED;
+        record.output_port_index = UNRESOLVED;
+        record.input_port_index = UNRESOLVED;
+        if (conn.contains("depth")) {
+            record.flags |= HAS_DEPTH;
+            record.depth = conn["depth"].get<uint64_t>();
+        }
+        if (conn.contains("max_bytes")) {
+            record.flags |= HAS_MAX_BYTES;
+            record.max_bytes = conn["max_bytes"].get<uint64_t>();
+        }
+        if (conn.contains("overflow")) {
+            auto overflow = conn["overflow"].get<std::string>();
+            if (overflow != "drop" && overflow != "block") {
+                throw std::runtime_error(fmt::format("invalid overflow policy '{}' for connection: {}", overflow, conn.dump()));
+            }
+            record.flags |= HAS_OVERFLOW;
+            record.overflow = static_cast<uint32_t>(overflow == "block" ? composite::overflow_policy::BLOCK : composite::overflow_policy::DROP);
+        }
+        if (conn.contains("wait_strategy")) {
+            record.flags |= HAS_CONNECTION_WAIT_STRATEGY;
+            record.wait_strategy = to_wait_strategy(conn);
+            record.spin_ns = conn.value("spin_ns", int64_t{0});
+        }
+        if (conn.contains("priority")) {
+            record.flags |= HAS_CONNECTION_PRIORITY;
+            record.priority = conn["priority"].get<int32_t>();
+        }
+        if (conn.contains("deadline_us")) {
+            record.flags |= HAS_CONNECTION_DEADLINE;
+            record.deadline_us = conn["deadline_us"].get<int64_t>();
+        }
+        check_input_attributes(record, conn);
+        m_connections.emplace_back(record);
+    }
+
+    auto build(header head) -> std::vector<std::byte> {
+        auto offset = align(sizeof(header));
+        auto place = [&offset](std::size_t count, std::size_t size) {
+            auto sec = section{offset, count};
+            offset = align(offset + count * size);
+            return sec;
+        };
+        head.properties = place(m_properties.size(), sizeof(property_record));
+        head.components = place(m_components.size(), sizeof(component_record));
+        head.connections = place(m_connections.size(), sizeof(connection_record));
+        head.strings = place(m_strings.size(), 1);
+
+        auto image = std::vector<std::byte>(offset);
+        auto copy = [&image](const section& sec, const void* data, std::size_t bytes) {
+            if (bytes > 0) {
+                std::memcpy(image.data() + sec.offset, data, bytes);
+            }
+        };
+        std::memcpy(image.data(), &head, sizeof(head));
+        copy(head.properties, m_properties.data(), m_properties.size() * sizeof(property_record));
+        copy(head.components, m_components.data(), m_components.size() * sizeof(component_record));
+        copy(head.connections, m_connections.data(), m_connections.size() * sizeof(connection_record));
+        copy(head.strings, m_strings.data(), m_strings.size());
+        return image;
+    }
+
+    auto property_count() const -> std::size_t {
+        return m_properties.size();
+    }
+
+private:
+    // Queue and scheduling attributes belong to the input port, so every
+    // connection into one port must agree on those it sets
+    auto check_input_attributes(const connection_record& record, const nlohmann::json& conn) -> void {
+        auto key = std::pair{std::string{str(record.input_component)}, std::string{str(record.input_port)}};
+        auto [iter, inserted] = m_inputs.try_emplace(std::move(key), record);
+        if (inserted) {
+            return;
+        }
+        auto& seen = iter->second;
+        auto check = [&](uint32_t flag, std::string_view name, auto seen_value, auto value) {
+            if ((record.flags & flag) == 0) {
+                return;
+            }
+            if ((seen.flags & flag) != 0 && seen_value != value) {
+                throw std::runtime_error(fmt::format("conflicting {} for input {}:{} in connection: {}", name,
+                    str(record.input_component), str(record.input_port), conn.dump()));
+            }
+        };
+        check(HAS_DEPTH, "depth", seen.depth, record.depth);
+        check(HAS_MAX_BYTES, "max_bytes", seen.max_bytes, record.max_bytes);
+        check(HAS_OVERFLOW, "overflow", seen.overflow, record.overflow);
+        check(HAS_CONNECTION_WAIT_STRATEGY, "wait_strategy", std::pair{seen.wait_strategy, seen.spin_ns},
+            std::pair{record.wait_strategy, record.spin_ns});
+        check(HAS_CONNECTION_PRIORITY, "priority", seen.priority, record.priority);
+        check(HAS_CONNECTION_DEADLINE, "deadline_us", seen.deadline_us, record.deadline_us);
+        // Remember attributes first set by this connection
+        auto merge = [&](uint32_t flag, auto& seen_value, auto value) {
+            if ((record.flags & flag) != 0 && (seen.flags & flag) == 0) {
+                seen.flags |= flag;
+                seen_value = value;
+            }
+        };
+        merge(HAS_DEPTH, seen.depth, record.depth);
+        merge(HAS_MAX_BYTES, seen.max_bytes, record.max_bytes);
+        merge(HAS_OVERFLOW, seen.overflow, record.overflow);
+        if ((record.flags & HAS_CONNECTION_WAIT_STRATEGY) != 0 && (seen.flags & HAS_CONNECTION_WAIT_STRATEGY) == 0) {
+            seen.spin_ns = record.spin_ns;
+        }
+        merge(HAS_CONNECTION_WAIT_STRATEGY, seen.wait_strategy, record.wait_strategy);
+        merge(HAS_CONNECTION_PRIORITY, seen.priority, record.priority);
+        merge(HAS_CONNECTION_DEADLINE, seen.deadline_us, record.deadline_us);
+    }
+
+    auto str(string_ref ref) const -> std::string_view {
+        return std::string_view{m_strings}.substr(ref.offset, ref.size);
+    }
+
+    struct string_hash {
+        using is_transparent = void;
+        auto operator()(std::string_view value) const noexcept -> std::size_t {
+            return std::hash<std::string_view>{}(value);
+        }
+    };
+
+    std::string m_strings;
+    std::unordered_map<std::string, string_ref, string_hash, std::equal_to<>> m_interned;
+    std::vector<property_record> m_properties;
+    std::vector<component_record> m_components;
+    std::vector<connection_record> m_connections;
+    std::map<std::pair<std::string, std::string>, connection_record> m_inputs;
+
+}; // class graph_cache::builder
+
+auto graph_cache::unmapper::operator()(const std::byte* data) const -> void {
+    munmap(const_cast<std::byte*>(data), size);
+}
+
+graph_cache::~graph_cache() = default;
+
+auto graph_cache::compile(const nlohmann::json& app_json) -> graph_cache {
+    auto build = builder{};
+    auto head = header{};
+    head.magic = MAGIC;
+    head.version = FORMAT_VERSION;
+    head.byte_order = ENDIAN_MARKER;
+    head.build_version = build_version();
+    try {
+        head.name = build.intern(app_json.at("name").get<std::string>());
+        if (app_json.contains("memory_budget_bytes")) {
+            head.flags |= HAS_MEMORY_BUDGET;
+            head.memory_budget_bytes = app_json["memory_budget_bytes"].get<uint64_t>();
+        }
+        if (app_json.contains("watchdog")) {
+            const auto& dog = app_json["watchdog"];
+            head.flags |= HAS_WATCHDOG;
+            head.watchdog_period_ms = dog.value("period_ms", int64_t{100});
+            head.watchdog_limit_ms = dog.value("limit_ms", int64_t{1000});
+        }
+        if (app_json.contains("properties")) {
+            for (const auto& prop : app_json["properties"]) {
+                build.add_property(prop);
+            }
+        }
+        head.app_property_count = static_cast<uint32_t>(build.property_count());
+        if (app_json.contains("components")) {
+            for (const auto& comp : app_json["components"]) {
+                build.add_component(comp);
+            }
+        }
+        if (app_json.contains("connections")) {
+            for (const auto& conn : app_json["connections"]) {
+                build.add_connection(conn);
+            }
+        }
+    } catch (const nlohmann::json::exception& err) {
+        throw std::runtime_error(fmt::format("invalid configuration: {}", err.what()));
+    }
+    auto graph = graph_cache{};
+    graph.m_buffer = build.build(head);
+    graph.m_data = graph.m_buffer;
+    return graph;
+}
+
+auto graph_cache::map(const std::string& path) -> graph_cache {
+    auto fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error(fmt::format("failed to open graph cache {}: {}", path, std::strerror(errno)));
+    }
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(header))) {
+        close(fd);
+        throw std::runtime_error(fmt::format("graph cache {} is truncated", path));
+    }
+    auto size = static_cast<std::size_t>(info.st_size);
+    auto addr = mmap(nullptr, size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        throw std::runtime_error(fmt::format("failed to map graph cache {}: {}", path, std::strerror(errno)));
+    }
+    auto graph = graph_cache{};
+    graph.m_mapping = std::unique_ptr<const std::byte, unmapper>{static_cast<const std::byte*>(addr), unmapper{size}};
+    graph.m_data = std::span{graph.m_mapping.get(), size};
+    try {
+        graph.validate();
+    } catch (const std::runtime_error& err) {
+        throw std::runtime_error(fmt::format("graph cache {}: {}", path, err.what()));
+    }
+    return graph;
+}
+
+auto graph_cache::is_cache(const std::string& path) -> bool {
+    auto magic = std::array<char, MAGIC.size()>{};
+    auto file = std::ifstream{path, std::ios::binary};
+    return file.read(magic.data(), magic.size()) && magic == MAGIC;
+}
+
+auto graph_cache::write(const std::string& path) const -> void {
+    // Write beside the target and rename, so running instances mapping the
+    // old cache keep a consistent file
+    auto temp_path = path + ".tmp";
+    {
+        auto file = std::ofstream{temp_path, std::ios::binary | std::ios::trunc};
+        file.write(reinterpret_cast<const char*>(m_data.data()), static_cast<std::streamsize>(m_data.size()));
+        if (!file) {
+            throw std::runtime_error(fmt::format("failed to write graph cache {}", temp_path));
+        }
+    }
+    if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+        throw std::runtime_error(fmt::format("failed to rename {} to {}: {}", temp_path, path, std::strerror(errno)));
+    }
+}
+
+auto graph_cache::resolve(std::size_t connection, const connection_record& resolved) -> void {
+    if (m_buffer.empty()) {
+        throw std::logic_error("a mapped graph cache is read-only");
+    }
+    const auto& head = this->head();
+    auto offset = head.connections.offset + connection * sizeof(connection_record);
+    auto record = connection_record{};
+    std::memcpy(&record, m_buffer.data() + offset, sizeof(record));
+    record.output_component_index = resolved.output_component_index;
+    record.input_component_index = resolved.input_component_index;
+    record.output_port_index = resolved.output_port_index;
+    record.input_port_index = resolved.input_port_index;
+    std::memcpy(m_buffer.data() + offset, &record, sizeof(record));
+}
+
+auto graph_cache::name() const -> std::string_view {
+    return str(head().name);
+}
+
+auto graph_cache::memory_budget_bytes() const -> std::optional<std::size_t> {
+    if ((head().flags & HAS_MEMORY_BUDGET) == 0) {
+        return std::nullopt;
+    }
+    return head().memory_budget_bytes;
+}
+
+auto graph_cache::watchdog() const -> std::optional<watchdog_settings> {
+    if ((head().flags & HAS_WATCHDOG) == 0) {
+        return std::nullopt;
+    }
+    return watchdog_settings{
+        std::chrono::milliseconds{head().watchdog_period_ms},
+        std::chrono::milliseconds{head().watchdog_limit_ms}
+    };
+}
+
+auto graph_cache::app_properties() const -> std::span<const property_record> {
+    return records<property_record>(head().properties).first(head().app_property_count);
+}
+
+auto graph_cache::components() const -> std::span<const component_record> {
+    return records<component_record>(head().components);
+}
+
+auto graph_cache::properties(const component_record& comp) const -> std::span<const property_record> {
+    return records<property_record>(head().properties).subspan(comp.first_property, comp.property_count);
+}
+
+auto graph_cache::connections() const -> std::span<const connection_record> {
+    return records<connection_record>(head().connections);
+}
+
+auto graph_cache::str(string_ref ref) const -> std::string_view {
+    const auto& strings = head().strings;
+    return {reinterpret_cast<const char*>(m_data.data() + strings.offset + ref.offset), ref.size};
+}
+
+auto graph_cache::string_value(const property_record& prop) const -> std::string_view {
+    return str(string_ref{static_cast<uint32_t>(prop.bits >> 32U), static_cast<uint32_t>(prop.bits)});
+}
+
+auto graph_cache::find_cycle() const -> std::vector<uint32_t> {
+    enum class mark : uint8_t { UNVISITED, ACTIVE, DONE };
+    const auto comps = components();
+    // Downstream components of each component, in compressed row form
+    auto first = std::vector<uint32_t>(comps.size() + 1, 0);
+    for (const auto& conn : connections()) {
+        ++first[conn.output_component_index + 1];
+    }
+    std::partial_sum(first.begin(), first.end(), first.begin());
+    auto next = first;
+    auto edges = std::vector<uint32_t>(connections().size());
+    for (const auto& conn : connections()) {
+        edges[next[conn.output_component_index]++] = conn.input_component_index;
+    }
+
+    // Iterative depth-first search, the current path is the cycle when a
+    // back edge is found
+    auto marks = std::vector<mark>(comps.size(), mark::UNVISITED);
+    auto path = std::vector<uint32_t>{};
+    auto cursor = std::vector<uint32_t>{};
+    for (uint32_t root = 0; root < comps.size(); ++root) {
+        if (marks[root] != mark::UNVISITED) {
+            continue;
+        }
+        marks[root] = mark::ACTIVE;
+        path.assign(1, root);
+        cursor.assign(1, first[root]);
+        while (!path.empty()) {
+            auto node = path.back();
+            if (cursor.back() == first[node + 1]) {
+                marks[node] = mark::DONE;
+                path.pop_back();
+                cursor.pop_back();
+                continue;
+            }
+            auto child = edges[cursor.back()++];
+            if (marks[child] == mark::ACTIVE) {
+                return {std::find(path.begin(), path.end(), child), path.end()};
+            }
+            if (marks[child] == mark::UNVISITED) {
+                marks[child] = mark::ACTIVE;
+                path.emplace_back(child);
+                cursor.emplace_back(first[child]);
+            }
+        }
+    }
+    return {};
+}
+
+auto graph_cache::head() const -> const header& {
+    return *reinterpret_cast<const header*>(m_data.data());
+}
+
+template <typename T>
+auto graph_cache::records(const section& sec) const -> std::span<const T> {
+    return {reinterpret_cast<const T*>(m_data.data() + sec.offset), static_cast<std::size_t>(sec.count)};
+}
+
+// Check every offset, index and size once, so later accessors need no checks
+auto graph_cache::validate() const -> void {
+    const auto& head = this->head();
+    if (head.magic != MAGIC) {
+        throw std::runtime_error("not a graph cache");
+    }
+    if (head.version != FORMAT_VERSION || head.byte_order != ENDIAN_MARKER || head.build_version != build_version()) {
+        throw std::runtime_error("incompatible graph cache version, recompile it");
+    }
+    auto check_section = [this](const section& sec, std::size_t size) {
+        if (sec.offset % RECORD_ALIGNMENT != 0 || sec.offset > m_data.size() ||
+            sec.count > (m_data.size() - sec.offset) / size) {
+            throw std::runtime_error("section out of bounds");
+        }
+    };
+    check_section(head.properties, sizeof(property_record));
+    check_section(head.components, sizeof(component_record));
+    check_section(head.connections, sizeof(connection_record));
+    check_section(head.strings, 1);
+    auto check_string = [&head](string_ref ref) {
+        if (uint64_t{ref.offset} + ref.size > head.strings.count) {
+            throw std::runtime_error("string out of bounds");
+        }
+    };
+    check_string(head.name);
+    if (head.app_property_count > head.properties.count) {
+        throw std::runtime_error("application properties out of bounds");
+    }
+    for (const auto& prop : records<property_record>(head.properties)) {
+        check_string(prop.name);
+        if (prop.type > property_type::DOUBLE) {
+            throw std::runtime_error("unknown property type");
+        }
+        if (prop.type == property_type::STRING) {
+            check_string(string_ref{static_cast<uint32_t>(prop.bits >> 32U), static_cast<uint32_t>(prop.bits)});
+        }
+    }
+    for (const auto& comp : components()) {
+        for (auto ref : {comp.name, comp.id, comp.module, comp.create_arg}) {
+            check_string(ref);
+        }
+        if (uint64_t{comp.first_property} + comp.property_count > head.properties.count) {
+            throw std::runtime_error("component properties out of bounds");
+        }
+        if ((comp.flags & HAS_WAIT_STRATEGY) != 0 && comp.wait_strategy > static_cast<uint32_t>(composite::wait_strategy::HYBRID)) {
+            throw std::runtime_error("unknown wait strategy");
+        }
+    }
+    for (const auto& conn : connections()) {
+        for (auto ref : {conn.output_component, conn.input_component, conn.output_port, conn.input_port}) {
+            check_string(ref);
+        }
+        auto check_index = [&head](uint32_t index) {
+            if (index != UNRESOLVED && index >= head.components.count) {
+                throw std::runtime_error("connection component out of bounds");
+            }
+        };
+        check_index(conn.output_component_index);
+        check_index(conn.input_component_index);
+        if ((conn.flags & HAS_CONNECTION_WAIT_STRATEGY) != 0 && conn.wait_strategy > static_cast<uint32_t>(composite::wait_strategy::HYBRID)) {
+            throw std::runtime_error("unknown wait strategy");
+        }
+        if ((conn.flags & HAS_OVERFLOW) != 0 && conn.overflow > static_cast<uint32_t>(composite::overflow_policy::BLOCK)) {
+            throw std::runtime_error("unknown overflow policy");
+        }
+    }
+}
@@ -0,0 +1,214 @@
+/*
+ * Copyright (C) 2024 Geon Technologies, LLC
+ *
+ * This file is part of composite.
+ *
+ * composite is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * composite is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <nlohmann/json_fwd.hpp>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+// An application configuration compiled into fixed-size records that refer
+// to each other by index and to a shared string table by offset. The same
+// image is built in memory from JSON or mapped from a cache file written by
+// write(), so a cached graph is used without any parsing.
+class graph_cache {
+public:
+    struct string_ref {
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    enum class property_type : uint32_t {
+        BOOL,
+        STRING,
+        INT32,
+        UINT32,
+        INT64,
+        UINT64,
+        FLOAT,
+        DOUBLE
+    };
+
+    struct property_record {
+        string_ref name;
+        property_type type;
+        uint32_t reserved;
+        uint64_t bits; // numeric value, or offset and size of a string
+    };
+
+    enum component_flags : uint32_t {
+        HAS_MODULE = 1U << 0U,
+        HAS_CREATE_ARG = 1U << 1U,
+        HAS_PRIORITY = 1U << 2U,
+        HAS_DEADLINE = 1U << 3U,
+        HAS_WAIT_STRATEGY = 1U << 4U,
+        HAS_ID = 1U << 5U
+    };
+
+    struct component_record {
+        string_ref name;
+        string_ref id;
+        string_ref module;
+        string_ref create_arg;
+        uint32_t flags;
+        int32_t priority;
+        int64_t deadline_us;
+        uint32_t wait_strategy;
+        uint32_t first_property;
+        uint32_t property_count;
+        uint32_t reserved;
+        int64_t spin_ns;
+    };
+
+    enum connection_flags : uint32_t {
+        HAS_DEPTH = 1U << 0U,
+        HAS_MAX_BYTES = 1U << 1U,
+        HAS_OVERFLOW = 1U << 2U,
+        HAS_CONNECTION_WAIT_STRATEGY = 1U << 3U,
+        HAS_CONNECTION_PRIORITY = 1U << 4U,
+        HAS_CONNECTION_DEADLINE = 1U << 5U
+    };
+
+    static constexpr uint32_t UNRESOLVED{0xffffffff};
+
+    struct connection_record {
+        string_ref output_component; // component id
+        string_ref input_component;
+        string_ref output_port;
+        string_ref input_port;
+        uint32_t output_component_index; // index into components(), once resolved
+        uint32_t input_component_index;
+        uint32_t output_port_index; // index into the component's ports, once resolved
+        uint32_t input_port_index;
+        uint32_t flags;
+        int32_t priority;
+        uint64_t depth;
+        uint64_t max_bytes;
+        uint32_t overflow;
+        uint32_t wait_strategy;
+        int64_t spin_ns;
+        int64_t deadline_us;
+    };
+
+    struct watchdog_settings {
+        std::chrono::milliseconds period;
+        std::chrono::milliseconds limit;
+    };
+
+    // Records are written to disk as-is, so none may contain padding
+    static_assert(std::has_unique_object_representations_v<property_record>);
+    static_assert(std::has_unique_object_representations_v<component_record>);
+    static_assert(std::has_unique_object_representations_v<connection_record>);
+
+    // Build a graph from an application configuration, checking that it is
+    // well formed. Connections name components by id, which may be set by the
+    // component itself, so they are resolved once components exist.
+    // Throws std::runtime_error on failure.
+    static auto compile(const nlohmann::json& app_json) -> graph_cache;
+
+    // Map a cache file written by write(). Throws std::runtime_error if the
+    // file is not a valid cache for this build.
+    static auto map(const std::string& path) -> graph_cache;
+
+    // Whether the file starts like a graph cache rather than JSON
+    static auto is_cache(const std::string& path) -> bool;
+
+    graph_cache(graph_cache&&) noexcept = default;
+    auto operator=(graph_cache&&) noexcept -> graph_cache& = default;
+    ~graph_cache();
+
+    auto write(const std::string& path) const -> void;
+
+    // Record the component and port indices a connection resolved to, so that
+    // graphs loaded from the cache skip looking them up by id and name
+    auto resolve(std::size_t connection, const connection_record& resolved) -> void;
+
+    auto name() const -> std::string_view;
+    auto memory_budget_bytes() const -> std::optional<std::size_t>;
+    auto watchdog() const -> std::optional<watchdog_settings>;
+    auto app_properties() const -> std::span<const property_record>;
+    auto components() const -> std::span<const component_record>;
+    auto properties(const component_record& comp) const -> std::span<const property_record>;
+    auto connections() const -> std::span<const connection_record>;
+
+    auto str(string_ref ref) const -> std::string_view;
+    auto string_value(const property_record& prop) const -> std::string_view;
+
+    // Indices of components forming a cycle, empty if the graph is acyclic.
+    // Connections must be resolved.
+    auto find_cycle() const -> std::vector<uint32_t>;
+
+private:
+    struct section {
+        uint64_t offset;
+        uint64_t count;
+    };
+
+    enum header_flags : uint32_t {
+        HAS_MEMORY_BUDGET = 1U << 0U,
+        HAS_WATCHDOG = 1U << 1U
+    };
+
+    struct header {
+        std::array<char, 8> magic;
+        uint32_t version;
+        uint32_t byte_order;
+        std::array<char, 16> build_version; // composite-cli version that wrote the cache
+        string_ref name;
+        uint32_t flags;
+        uint32_t app_property_count;
+        uint64_t memory_budget_bytes;
+        int64_t watchdog_period_ms;
+        int64_t watchdog_limit_ms;
+        section properties;
+        section components;
+        section connections;
+        section strings;
+    };
+
+    static_assert(std::has_unique_object_representations_v<header>);
+
+    struct unmapper {
+        std::size_t size;
+        auto operator()(const std::byte* data) const -> void;
+    };
+
+    class builder;
+
+    graph_cache() = default;
+
+    auto head() const -> const header&;
+    template <typename T>
+    auto records(const section& sec) const -> std::span<const T>;
+    auto validate() const -> void;
+
+    std::vector<std::byte> m_buffer;
+    std::unique_ptr<const std::byte, unmapper> m_mapping{nullptr, unmapper{0}};
+    std::span<const std::byte> m_data;
+
+}; // class graph_cache
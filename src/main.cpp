@@ -18,41 +18,402 @@
  */
  
 #include "composite/application.hpp"
+#include "composite/profiler.hpp"
 #include "composite/version.hpp"
+#include "graph_cache.hpp"
+#include "plugin_registry.hpp"
 
 #include <argparse/argparse.hpp>
+#include <array>
 #include <atomic>
+#include <bit>
+#include <cerrno>
+#include <chrono>
 #include <csignal>
-#include <dlfcn.h>
+#include <cstring>
+#include <fcntl.h>
 #include <fmt/core.h>
+#include <fmt/ranges.h>
 #include <fstream>
 #include <functional>
 #include <future>
 #include <iostream>
+#include <limits>
 #include <nlohmann/json.hpp>
+#include <optional>
+#include <poll.h>
 #include <spdlog/spdlog.h>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <unistd.h>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
-auto set_property(std::shared_ptr<composite::component> comp, const nlohmann::json& prop) {
-    auto type = prop["type"].get<std::string>();
-    auto name = prop["name"].get<std::string>();
-    auto value = prop["value"];
-    if (type == "bool") {
-        comp->set_property(name, value.get<bool>());
-    } else if (type == "string") {
-        comp->set_property(name, value.get<std::string>());
-    } else if (type == "int32") {
-        comp->set_property(name, value.get<int32_t>());
-    } else if (type == "uint32") {
-        comp->set_property(name, value.get<uint32_t>());
-    } else if (type == "int64") {
-        comp->set_property(name, value.get<int64_t>());
-    } else if (type == "uint64") {
-        comp->set_property(name, value.get<uint64_t>());
-    } else if (type == "float") {
-        comp->set_property(name, value.get<float>());
-    }  else if (type == "double") {
-        comp->set_property(name, value.get<double>());
+auto set_property(
+  const std::shared_ptr<composite::component>& comp,
+  const graph_cache& graph,
+  const graph_cache::property_record& prop
+) -> void {
+    using enum graph_cache::property_type;
+    auto name = graph.str(prop.name);
+    switch (prop.type) {
+        case BOOL:
+            comp->set_property(name, prop.bits != 0);
+            break;
+        case STRING:
+            comp->set_property(name, std::string{graph.string_value(prop)});
+            break;
+        case INT32:
+            comp->set_property(name, static_cast<int32_t>(std::bit_cast<int64_t>(prop.bits)));
+            break;
+        case UINT32:
+            comp->set_property(name, static_cast<uint32_t>(prop.bits));
+            break;
+        case INT64:
+            comp->set_property(name, std::bit_cast<int64_t>(prop.bits));
+            break;
+        case UINT64:
+            comp->set_property(name, prop.bits);
+            break;
+        case FLOAT:
+            comp->set_property(name, static_cast<float>(std::bit_cast<double>(prop.bits)));
+            break;
+        case DOUBLE:
+            comp->set_property(name, std::bit_cast<double>(prop.bits));
+            break;
+    }
+}
+
+// Apply a wait strategy to ports
+auto set_wait_strategy(const std::vector<composite::port*>& ports, uint32_t strategy, int64_t spin_ns) -> void {
+    for (auto port : ports) {
+        port->wait_strategy(static_cast<composite::wait_strategy>(strategy), std::chrono::nanoseconds{spin_ns});
+    }
+}
+
+// Create a component described by a graph, with the application-level
+// properties of app_graph
+auto create_component(
+  const graph_cache& graph,
+  const graph_cache::component_record& comp,
+  const graph_cache& app_graph,
+  plugin_registry& registry
+) -> std::shared_ptr<composite::component> {
+    // Get component name
+    auto name = graph.str(comp.name);
+    // Get the module providing it and the create arg, if present
+    auto module = std::optional<std::string_view>{};
+    if ((comp.flags & graph_cache::HAS_MODULE) != 0) {
+        module = graph.str(comp.module);
+    }
+    auto create_arg = std::optional<std::string_view>{};
+    if ((comp.flags & graph_cache::HAS_CREATE_ARG) != 0) {
+        create_arg = graph.str(comp.create_arg);
+    }
+    // Create a new component
+    auto comp_ptr = std::shared_ptr<composite::component>{nullptr};
+    try {
+        comp_ptr = registry.create(name, module, create_arg);
+    } catch (const std::runtime_error& err) {
+        spdlog::error(err.what());
+        return nullptr;
+    }
+    if (comp_ptr == nullptr) {
+        spdlog::error("failed to create component {}", name);
+        return nullptr;
+    }
+    // Set id, if present
+    if ((comp.flags & graph_cache::HAS_ID) != 0) {
+        comp_ptr->id(graph.str(comp.id));
+    }
+    // Set scheduling attributes
+    if ((comp.flags & graph_cache::HAS_PRIORITY) != 0) {
+        comp_ptr->priority(comp.priority);
+    }
+    if ((comp.flags & graph_cache::HAS_DEADLINE) != 0) {
+        comp_ptr->deadline(std::chrono::microseconds{comp.deadline_us});
+    }
+    // Set how all input ports wait for data, connections may override
+    if ((comp.flags & graph_cache::HAS_WAIT_STRATEGY) != 0) {
+        set_wait_strategy(comp_ptr->ports(), comp.wait_strategy, comp.spin_ns);
+    }
+    spdlog::trace("component {} created", comp_ptr->id());
+    // Set application-level properties
+    spdlog::trace("setting app-level properties on {}", comp_ptr->id());
+    for (const auto& prop : app_graph.app_properties()) {
+        set_property(comp_ptr, app_graph, prop);
+    }
+    // Set component-level properties
+    spdlog::trace("setting component-level properties on {}", comp_ptr->id());
+    for (const auto& prop : graph.properties(comp)) {
+        set_property(comp_ptr, graph, prop);
+    }
+    return comp_ptr;
+}
+
+// Look a component up by the index resolved when the graph was compiled,
+// falling back to its id, where the first component with the id wins as in
+// application::get_component. Updates index to the component found.
+auto find_component(
+  const std::vector<std::shared_ptr<composite::component>>& comps,
+  const std::unordered_map<std::string, uint32_t>& ids,
+  uint32_t& index,
+  std::string_view id
+) -> composite::component* {
+    if (index < comps.size() && comps[index]->id() == id) {
+        return comps[index].get();
+    }
+    auto iter = ids.find(std::string{id});
+    if (iter == ids.end()) {
+        return nullptr;
+    }
+    index = iter->second;
+    return comps[index].get();
+}
+
+// Look a port up by the index resolved when the graph was compiled, falling
+// back to its name if the component's ports have changed since. Updates
+// index to the port found.
+auto find_port(composite::component& comp, uint32_t& index, std::string_view name) -> composite::port* {
+    if (auto port = comp.port_at(index); port != nullptr && port->name() == name) {
+        return port;
+    }
+    auto found = comp.port_index(name);
+    if (!found) {
+        return nullptr;
+    }
+    index = static_cast<uint32_t>(*found);
+    return comp.port_at(index);
+}
+
+// Connect two components as described by a connection record, applying its
+// queue and scheduling attributes to the input port. The record's indices
+// are updated to the components and ports it resolved to.
+auto connect(
+  const graph_cache& graph,
+  graph_cache::connection_record& conn,
+  const std::vector<std::shared_ptr<composite::component>>& comps,
+  const std::unordered_map<std::string, uint32_t>& ids
+) -> std::optional<std::string> {
+    auto output_comp = find_component(comps, ids, conn.output_component_index, graph.str(conn.output_component));
+    if (output_comp == nullptr) {
+        return fmt::format("output component {} does not exist", graph.str(conn.output_component));
+    }
+    auto input_comp = find_component(comps, ids, conn.input_component_index, graph.str(conn.input_component));
+    if (input_comp == nullptr) {
+        return fmt::format("input component {} does not exist", graph.str(conn.input_component));
+    }
+    auto output_port_name = graph.str(conn.output_port);
+    auto input_port_name = graph.str(conn.input_port);
+    auto out_port = find_port(*output_comp, conn.output_port_index, output_port_name);
+    if (out_port == nullptr) {
+        return fmt::format("output port {}:{} does not exist", output_comp->id(), output_port_name);
+    }
+    auto in_port = find_port(*input_comp, conn.input_port_index, input_port_name);
+    if (in_port == nullptr) {
+        return fmt::format("input port {}:{} does not exist", input_comp->id(), input_port_name);
+    }
+    if (out_port->type_id() != in_port->type_id()) {
+        return fmt::format("types of {}:{} and {}:{} do not match", output_comp->id(), output_port_name,
+            input_comp->id(), input_port_name);
+    }
+    if ((conn.flags & graph_cache::HAS_DEPTH) != 0) {
+        in_port->depth(conn.depth);
+    }
+    if ((conn.flags & graph_cache::HAS_MAX_BYTES) != 0) {
+        in_port->max_bytes(conn.max_bytes);
+    }
+    if ((conn.flags & graph_cache::HAS_OVERFLOW) != 0) {
+        in_port->overflow(static_cast<composite::overflow_policy>(conn.overflow));
+    }
+    if ((conn.flags & graph_cache::HAS_CONNECTION_WAIT_STRATEGY) != 0) {
+        set_wait_strategy({in_port}, conn.wait_strategy, conn.spin_ns);
+    }
+    if ((conn.flags & graph_cache::HAS_CONNECTION_PRIORITY) != 0) {
+        in_port->priority(conn.priority);
+    }
+    if ((conn.flags & graph_cache::HAS_CONNECTION_DEADLINE) != 0) {
+        in_port->deadline(std::chrono::microseconds{conn.deadline_us});
+    }
+    spdlog::trace("connecting {}:{} to {}:{}", output_comp->id(), output_port_name, input_comp->id(), input_port_name);
+    out_port->connect(in_port);
+    return std::nullopt;
+}
+
+// Read a graph cache written by --compile, or compile a JSON configuration
+auto load_graph(const std::string& config_file) -> graph_cache {
+    if (graph_cache::is_cache(config_file)) {
+        return graph_cache::map(config_file);
+    }
+    auto config_ifstream = std::ifstream{config_file};
+    if (!config_ifstream) {
+        throw std::runtime_error(fmt::format("failed to open config file {}", config_file));
+    }
+    auto app_json = nlohmann::json::parse(config_ifstream, nullptr, false);
+    if (app_json.is_discarded()) {
+        throw std::runtime_error(fmt::format("failed to parse config file {}", config_file));
+    }
+    return graph_cache::compile(app_json);
+}
+
+// Log queued bytes and drops for every port holding data or losing it
+auto log_port_usage(const composite::application& app) -> void {
+    const auto& budget = app.memory_budget();
+    if (budget.limit() != std::numeric_limits<std::size_t>::max()) {
+        spdlog::info("memory budget: {} of {} bytes used", budget.used(), budget.limit());
+    }
+    for (const auto& comp : app.components()) {
+        for (auto port : comp->ports()) {
+            if (port->bytes() > 0 || port->dropped() > 0) {
+                spdlog::info("{}:{}: {} bytes queued, {} dropped", comp->id(), port->name(), port->bytes(), port->dropped());
+            }
+        }
+    }
+}
+
+// Print throughput and latency measured by bench_sink components and the
+// drops seen by every port
+auto print_bench_report(const composite::application& app, double elapsed) -> void {
+    static constexpr double BYTES_PER_MB{1e6};
+    static constexpr double NS_PER_US{1e3};
+    fmt::print("\nbenchmark '{}': {:.3f} s\n\n", app.name(), elapsed);
+    fmt::print("{:<20} {:>12} {:>12} {:>12} {:>14} {:>14}\n",
+        "sink", "packets", "packets/s", "MB/s", "mean lat (us)", "max lat (us)");
+    for (const auto& comp : app.components()) {
+        if (!comp->has_property("bench_packets")) {
+            continue;
+        }
+        auto packets = comp->get_property<uint64_t>("bench_packets");
+        auto bytes = comp->get_property<uint64_t>("bench_bytes");
+        auto latency_sum = comp->get_property<uint64_t>("bench_latency_sum_ns");
+        auto latency_max = comp->get_property<uint64_t>("bench_latency_max_ns");
+        auto latency_mean = (packets > 0) ? static_cast<double>(latency_sum) / static_cast<double>(packets) : 0.0;
+        fmt::print("{:<20} {:>12} {:>12.1f} {:>12.2f} {:>14.1f} {:>14.1f}\n",
+            comp->id(), packets, static_cast<double>(packets) / elapsed,
+            static_cast<double>(bytes) / BYTES_PER_MB / elapsed,
+            latency_mean / NS_PER_US, static_cast<double>(latency_max) / NS_PER_US);
+    }
+    auto total_dropped = uint64_t{0};
+    fmt::print("\n{:<32} {:>12}\n", "port", "dropped");
+    for (const auto& comp : app.components()) {
+        for (auto port : comp->ports()) {
+            if (port->dropped() > 0) {
+                fmt::print("{:<32} {:>12}\n", fmt::format("{}:{}", comp->id(), port->name()), port->dropped());
+                total_dropped += port->dropped();
+            }
+        }
+    }
+    fmt::print("{:<32} {:>12}\n\n", "total", total_dropped);
+}
+
+// Split a "<component>:<port>" endpoint into its parts
+auto parse_endpoint(std::string_view endpoint) -> std::optional<std::pair<std::string, std::string>> {
+    auto pos = endpoint.find(':');
+    if (pos == std::string_view::npos || pos == 0 || pos == endpoint.size() - 1) {
+        return std::nullopt;
+    }
+    return std::pair{std::string{endpoint.substr(0, pos)}, std::string{endpoint.substr(pos + 1)}};
+}
+
+// Apply a single control command to a running application. Supported commands:
+//   connect <component>:<port> <component>:<port>
+//   disconnect <component>:<port> <component>:<port>
+//   add <component json>
+//   remove <component id>
+//   stats
+auto run_control_command(
+  composite::application& app,
+  std::string_view line,
+  const graph_cache& app_graph,
+  plugin_registry& registry
+) -> void {
+    auto stream = std::istringstream{std::string{line}};
+    auto command = std::string{};
+    stream >> command;
+    if (command.empty()) {
+        return;
+    }
+    if (command == "connect" || command == "disconnect") {
+        auto output = std::string{};
+        auto input = std::string{};
+        stream >> output >> input;
+        auto output_ep = parse_endpoint(output);
+        auto input_ep = parse_endpoint(input);
+        if (!output_ep || !input_ep) {
+            spdlog::error("control: expected '{} <component>:<port> <component>:<port>'", command);
+            return;
+        }
+        const auto& [output_comp, output_port] = *output_ep;
+        const auto& [input_comp, input_port] = *input_ep;
+        auto success = (command == "connect") ?
+            app.connect(output_comp, output_port, input_comp, input_port) :
+            app.disconnect(output_comp, output_port, input_comp, input_port);
+        if (!success) {
+            spdlog::error("control: failed to {} {} to {}", command, output, input);
+            return;
+        }
+        spdlog::info("control: {} {} to {}", command, output, input);
+    } else if (command == "add") {
+        auto comp_json = nlohmann::json::parse(std::string{std::istreambuf_iterator<char>{stream}, {}}, nullptr, false);
+        if (comp_json.is_discarded() || !comp_json.contains("name")) {
+            spdlog::error("control: expected 'add <component json>'");
+            return;
+        }
+        auto comp_graph = std::optional<graph_cache>{};
+        try {
+            comp_graph = graph_cache::compile(nlohmann::json{{"name", app_graph.name()}, {"components", {comp_json}}});
+        } catch (const std::runtime_error& err) {
+            spdlog::error("control: {}", err.what());
+            return;
+        }
+        auto comp_ptr = create_component(*comp_graph, comp_graph->components().front(), app_graph, registry);
+        if (comp_ptr == nullptr) {
+            return;
+        }
+        if (app.get_component(comp_ptr->id()) != nullptr) {
+            spdlog::error("control: component {} already exists", comp_ptr->id());
+            return;
+        }
+        app.add_component(comp_ptr);
+        spdlog::info("control: added {}", comp_ptr->id());
+    } else if (command == "remove") {
+        auto id = std::string{};
+        stream >> id;
+        if (!app.remove_component(id)) {
+            spdlog::error("control: failed to remove {}", id);
+            return;
+        }
+        spdlog::info("control: removed {}", id);
+    } else if (command == "stats") {
+        log_port_usage(app);
+    } else {
+        spdlog::error("control: unknown command '{}'", command);
+    }
+}
+
+// Read newline-delimited commands from a control file descriptor until stopped
+auto control_loop(std::stop_token token, int fd, const std::function<void(std::string_view)>& handler) -> void {
+    static constexpr int POLL_TIMEOUT{100}; // milliseconds
+    auto pending = std::string{};
+    auto buffer = std::array<char, 4096>{};
+    while (!token.stop_requested()) {
+        auto pfd = pollfd{fd, POLLIN, 0};
+        if (poll(&pfd, 1, POLL_TIMEOUT) <= 0) {
+            continue;
+        }
+        auto count = read(fd, buffer.data(), buffer.size());
+        if (count <= 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds{POLL_TIMEOUT});
+            continue;
+        }
+        pending.append(buffer.data(), static_cast<std::size_t>(count));
+        for (auto pos = pending.find('\n'); pos != std::string::npos; pos = pending.find('\n')) {
+            handler(std::string_view{pending}.substr(0, pos));
+            pending.erase(0, pos + 1);
+        }
     }
 }
 
@@ -62,6 +423,19 @@ auto main(int argc, char** argv) -> int {
     program.add_argument("-c", "--config")
         .help("application configuration file")
         .required();
+    program.add_argument("--compile")
+        .help("validate the configuration and write it to this file as a binary graph cache, which --config accepts in place of JSON");
+    program.add_argument("--control")
+        .help("named pipe to read runtime control commands from (connect, disconnect, add, remove, stats)");
+    program.add_argument("--profile")
+        .help("record a Chrome trace of component and port activity to this file (SIGUSR1 toggles recording)");
+    program.add_argument("--profile-events")
+        .help("events kept per thread by --profile, older events are overwritten")
+        .default_value(composite::profiler::DEFAULT_CAPACITY)
+        .scan<'u', std::size_t>();
+    program.add_argument("--bench")
+        .help("run for the given number of seconds, then print a throughput, latency and drop report")
+        .scan<'g', double>();
     program.add_argument("-l", "--log-level")
       .help("log level [trace, debug, info, warning, error, critical, off]")
       .default_value(std::string{"info"});
@@ -82,134 +456,108 @@ auto main(int argc, char** argv) -> int {
     // Get configuration file, then read and parse
     auto config_file = program.get<std::string>("--config");
     spdlog::info("Using config file at: {}", config_file);
-    auto config_ifstream = std::ifstream{config_file};
-    auto app_json = nlohmann::json::parse(config_ifstream);
+    auto graph = std::optional<graph_cache>{};
+    try {
+        graph = load_graph(config_file);
+    } catch (const std::runtime_error& err) {
+        spdlog::error(err.what());
+        return EXIT_FAILURE;
+    }
+    auto compile_file = program.present<std::string>("--compile");
 
-    // Component handle holders
-    auto close_func = [](void* p) {
-        dlclose(p);
-    };
-    auto comp_handles = std::vector<std::unique_ptr<void, decltype(close_func)>>{};
+    // Component modules, kept loaded until the application is destroyed
+    auto registry = plugin_registry{};
 
     // Create a new application object
-    auto app_name = app_json["name"].get<std::string>();
-    auto app = composite::application{app_name};
-
-    // Get components and load them
-    for (const auto& comp : app_json["components"]) {
-        // Get component name
-        auto name = comp["name"].get<std::string>();
-        // Open component module
-        auto comp_str = fmt::format("lib{}.so", name);
-        spdlog::trace("component module: {}", comp_str);
-        // Get component module handle
-        auto comp_handle = std::unique_ptr<void, decltype(close_func)>(dlopen(comp_str.c_str(), RTLD_NOW), close_func);
-        if (!comp_handle) {
-            std::cerr << fmt::format("failed to open {}: {}\n", comp_str, dlerror());
-            return EXIT_FAILURE;
-        }
-        dlerror(); // clear existing
-        // Component shared_ptr
-        auto comp_ptr = std::shared_ptr<composite::component>{nullptr};
-        // Get the create function
-        if (comp.contains("create_arg")) {
-            // Get create arg if present
-            auto create_arg = comp["create_arg"].get<std::string>();
-            // Create function to include string_view argument
-            using function_ptr = std::shared_ptr<composite::component> (*)(std::string_view);
-            auto create_func = reinterpret_cast<function_ptr>(dlsym(comp_handle.get(), "create"));
-            if (auto err = dlerror(); err != nullptr) {
-                std::cerr << fmt::format("failed to find the 'create' symbol from {}: {}\n", comp_str, err);
-                return EXIT_FAILURE;
-            }
-            dlerror(); // clear existing
-            // Create a new component
-            comp_ptr = (*create_func)(create_arg);
-        } else {
-            // Empty create function
-            using function_ptr = std::shared_ptr<composite::component> (*)();
-            auto create_func = reinterpret_cast<function_ptr>(dlsym(comp_handle.get(), "create"));
-            if (auto err = dlerror(); err != nullptr) {
-                std::cerr << fmt::format("failed to find the 'create' symbol from {}: {}\n", comp_str, err);
-                return EXIT_FAILURE;
+    auto app = composite::application{graph->name()};
+
+    // Limit the memory held in port queues
+    if (auto budget = graph->memory_budget_bytes()) {
+        app.memory_budget(*budget);
+    }
+
+    // Report stalled components and queues
+    if (auto dog = graph->watchdog(); dog && !compile_file) {
+        app.watchdog(dog->period, dog->limit, [](const composite::watchdog_event& event) {
+            const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(event.duration).count();
+            if (event.port.empty()) {
+                spdlog::warn("watchdog: {} {} for {} ms", event.component, composite::to_string(event.type), ms);
+            } else {
+                spdlog::warn("watchdog: {}.{} {} for {} ms", event.component, event.port, composite::to_string(event.type), ms);
             }
-            dlerror(); // clear existing
-            // Create a new component
-            comp_ptr = (*create_func)();
-        }
+        });
+        spdlog::info("Watchdog checking every {} ms, limit {} ms", dog->period.count(), dog->limit.count());
+    }
+
+    // Get components and load them, connections refer to them by id
+    auto comps = std::vector<std::shared_ptr<composite::component>>{};
+    auto ids = std::unordered_map<std::string, uint32_t>{};
+    comps.reserve(graph->components().size());
+    for (const auto& comp : graph->components()) {
+        auto comp_ptr = create_component(*graph, comp, *graph, registry);
         if (comp_ptr == nullptr) {
-            spdlog::error("failed to create component {}", name);
             return EXIT_FAILURE;
         }
-        // Set id if needed
-        if (comp.contains("id")) {
-            comp_ptr->id(comp["id"].get<std::string>());
-        }
-        spdlog::trace("component {} created", comp_ptr->id());
-        // Set application-level properties
-        spdlog::trace("setting app-level properties on {}", comp_ptr->id());
-        for (const auto& prop : app_json["properties"]) {
-            set_property(comp_ptr, prop);
-        }
-        // Set component-level properties
-        spdlog::trace("setting component-level properties on {}", comp_ptr->id());
-        for (const auto& prop : comp["properties"]) {
-            set_property(comp_ptr, prop);
-        }
         // Add to application
         spdlog::trace("adding {} to application '{}'", comp_ptr->id(), app.name());
         app.add_component(comp_ptr);
-        // Store handle for closing later
-        comp_handles.emplace_back(std::move(comp_handle));
+        if (!ids.try_emplace(comp_ptr->id(), static_cast<uint32_t>(comps.size())).second && compile_file) {
+            spdlog::warn("component id {} is used more than once, connections refer to the first", comp_ptr->id());
+        }
+        comps.emplace_back(std::move(comp_ptr));
+    }
+    for (const auto& stats : registry.stats()) {
+        spdlog::info("{}: loaded in {:.3f} ms, {} components created in {:.3f} ms", stats.path,
+            std::chrono::duration<double, std::milli>(stats.load_time).count(), stats.created,
+            std::chrono::duration<double, std::milli>(stats.create_time).count());
     }
 
-    // Make connections
-    auto conn_exit = [&app](std::string_view msg) {
-        spdlog::error(msg);
-        app.clear();
-        return EXIT_FAILURE;
-    };
-    for (const auto& conn : app_json["connections"]) {
-        if (!conn.contains("output")) {
-            return conn_exit(fmt::format("missing output for connection: {}", conn.dump()));
-        }
-        if (!conn.contains("input")) {
-            return conn_exit(fmt::format("missing output for connection: {}", conn.dump()));
-        }
-        auto output = conn["output"];
-        auto input = conn["input"];
-        if (!output.contains("component")) {
-            return conn_exit(fmt::format("missing component in connection output: {}", conn.dump()));
-        }
-        if (!output.contains("port")) {
-            return conn_exit(fmt::format("missing port in connection output: {}", conn.dump()));
-        }
-        if (!input.contains("component")) {
-            return conn_exit(fmt::format("missing component in connection input: {}", conn.dump()));
-        }
-        if (!input.contains("port")) {
-            return conn_exit(fmt::format("missing port in connection input: {}", conn.dump()));
+    // Make connections, keeping what they resolved to for the graph cache
+    auto conns = graph->connections();
+    for (std::size_t i = 0; i < conns.size(); ++i) {
+        auto conn = conns[i];
+        if (auto err = connect(*graph, conn, comps, ids)) {
+            spdlog::error(*err);
+            app.clear();
+            return EXIT_FAILURE;
         }
-        auto output_comp = output["component"].get<std::string>();
-        auto output_port = output["port"].get<std::string>();
-        auto input_comp = input["component"].get<std::string>();
-        auto input_port = input["port"].get<std::string>();
-        auto output_comp_ptr = app.get_component(output_comp);
-        if (output_comp_ptr == nullptr) {
-            return conn_exit(fmt::format("output component {} null during connection: {}", output_comp, conn.dump()));
+        if (compile_file) {
+            graph->resolve(i, conn);
         }
-        auto input_comp_ptr = app.get_component(input_comp);
-        if (input_comp_ptr == nullptr) {
-            return conn_exit(fmt::format("input component {} null during connection: {}", input_comp, conn.dump()));
+    }
+
+    // Write the validated graph and exit without running it
+    if (compile_file) {
+        if (auto cycle = graph->find_cycle(); !cycle.empty()) {
+            auto path = std::vector<std::string>{};
+            for (auto index : cycle) {
+                path.emplace_back(comps[index]->id());
+            }
+            path.emplace_back(path.front());
+            spdlog::error("connections form a cycle: {}", fmt::join(path, " -> "));
+            app.clear();
+            return EXIT_FAILURE;
         }
-        spdlog::trace("connecting {}:{} to {}:{}", output_comp, output_port, input_comp, input_port);
-        if (!output_comp_ptr->connect(output_port, input_comp_ptr, input_port)) {
-            return conn_exit(fmt::format("Failed to connect {}:{} to {}:{}", output_comp, output_port, input_comp, input_port));
+        try {
+            graph->write(*compile_file);
+        } catch (const std::runtime_error& err) {
+            spdlog::error(err.what());
+            app.clear();
+            return EXIT_FAILURE;
         }
+        spdlog::info("Compiled {} components and {} connections to: {}", graph->components().size(),
+            graph->connections().size(), *compile_file);
+        app.clear();
+        return EXIT_SUCCESS;
     }
 
     // Setup signal handlers
+    auto profile_file = program.present<std::string>("--profile");
     auto signals = std::vector<int>{SIGINT, SIGKILL};
+    if (profile_file) {
+        // SIGUSR1 pauses and resumes profiling
+        signals.emplace_back(SIGUSR1);
+    }
     auto sigset = sigset_t{};
     sigemptyset(&sigset);
     for (const auto& sig : signals) {
@@ -219,26 +567,109 @@ auto main(int argc, char** argv) -> int {
     auto signal_future = std::async(std::launch::async, [&sigset]() {
         auto signum = int{};
         sigwait(&sigset, &signum);
+        while (signum == SIGUSR1) {
+            auto enabled = composite::profiler::instance().toggle();
+            spdlog::info("profiling {}", enabled ? "resumed" : "paused");
+            sigwait(&sigset, &signum);
+        }
         printf("\r  \r");
         return signum;
     });
 
+    // Start recording before any component thread runs
+    if (profile_file) {
+        spdlog::info("Profiling to: {}", *profile_file);
+        composite::profiler::instance().capacity(program.get<std::size_t>("--profile-events"));
+        composite::profiler::instance().enable(true);
+    }
+
     // Initialize the application
     spdlog::trace("initializing application '{}'", app.name());
     app.initialize();
 
     // Start the application
     spdlog::trace("starting application '{}'", app.name());
+    auto start_time = std::chrono::steady_clock::now();
     app.start();
 
+    // Listen for runtime control commands
+    auto control_fd = -1;
+    auto control_thread = std::jthread{};
+    if (auto control_file = program.present<std::string>("--control")) {
+        // Open read-write so the pipe stays open between writers
+        control_fd = open(control_file->c_str(), O_RDWR | O_NONBLOCK);
+        if (control_fd < 0) {
+            spdlog::error("failed to open control file {}: {}", *control_file, std::strerror(errno));
+        } else {
+            spdlog::info("Listening for control commands on: {}", *control_file);
+            control_thread = std::jthread{[&](std::stop_token token) {
+                control_loop(token, control_fd, [&](std::string_view line) {
+                    run_control_command(app, line, *graph, registry);
+                });
+            }};
+        }
+    }
+
+    // Warn about priorities that could not be applied
+    for (const auto& comp : app.components()) {
+        if (!comp->priority_applied()) {
+            spdlog::warn("failed to apply priority {} to {}", comp->priority(), comp->id());
+        }
+    }
+
     // Wait for signal to stop
+    auto bench_seconds = program.present<double>("--bench");
+    if (bench_seconds) {
+        spdlog::info("Benchmarking for {} seconds", *bench_seconds);
+        if (signal_future.wait_for(std::chrono::duration<double>{*bench_seconds}) == std::future_status::timeout) {
+            // Release the signal waiter
+            kill(getpid(), SIGINT);
+        }
+    }
     spdlog::trace("waiting for signal...");
     signal_future.wait();
 
+    // Stop accepting control commands
+    if (control_thread.joinable()) {
+        control_thread.request_stop();
+        control_thread.join();
+        close(control_fd);
+    }
+
     // Stop the application
     spdlog::trace("stopping application '{}'", app.name());
+    auto elapsed = std::chrono::duration<double>{std::chrono::steady_clock::now() - start_time};
     app.stop();
 
+    if (bench_seconds) {
+        print_bench_report(app, elapsed.count());
+    }
+
+    // Report queue memory usage and drops
+    log_port_usage(app);
+
+    // Report deadline misses on latency-critical paths
+    for (const auto& comp : app.components()) {
+        if (comp->deadline().count() > 0) {
+            spdlog::info("{}: {} process() deadline misses", comp->id(), comp->deadline_misses());
+        }
+        for (auto port : comp->ports()) {
+            if (port->deadline().count() > 0) {
+                spdlog::info("{}:{}: {} queue deadline misses", comp->id(), port->name(), port->deadline_misses());
+            }
+        }
+    }
+
+    // Write out the recorded trace
+    if (profile_file) {
+        composite::profiler::instance().enable(false);
+        auto trace_ofstream = std::ofstream{*profile_file};
+        composite::profiler::instance().write_trace(trace_ofstream);
+        if (auto overwritten = composite::profiler::instance().overwritten(); overwritten > 0) {
+            spdlog::info("profiler buffers wrapped, the oldest {} events were overwritten", overwritten);
+        }
+    }
+
     // Clean up the application resources
     spdlog::trace("clearing application '{}'", app.name());
     app.clear();
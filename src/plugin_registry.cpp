@@ -0,0 +1,150 @@
+/*
+ * Copyright (C) 2024 Geon Technologies, LLC
+ *
+ * This file is part of composite.
+ *
+ * composite is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * composite is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+ 
+#include "plugin_registry.hpp"
+
+#include <dlfcn.h>
+#include <fmt/core.h>
+#include <stdexcept>
+
+namespace {
+
+auto elapsed_since(std::chrono::steady_clock::time_point begin) -> std::chrono::nanoseconds {
+    return std::chrono::steady_clock::now() - begin;
+}
+
+auto invoke(
+  const composite::component_factory& factory,
+  std::optional<std::string_view> create_arg
+) -> std::shared_ptr<composite::component> {
+    if (create_arg) {
+        if (factory.create_with_arg == nullptr) {
+            throw std::runtime_error(fmt::format("component '{}' does not take a create argument", factory.name));
+        }
+        return factory.create_with_arg(*create_arg);
+    }
+    if (factory.create == nullptr) {
+        throw std::runtime_error(fmt::format("component '{}' requires a create argument", factory.name));
+    }
+    return factory.create();
+}
+
+} // namespace
+
+struct plugin_registry::module {
+    struct handle_deleter {
+        auto operator()(void* handle) const -> void {
+            dlclose(handle);
+        }
+    };
+
+    std::unique_ptr<void, handle_deleter> handle;
+    std::map<std::string, composite::component_factory, std::less<>> factories;
+    composite::component_factory legacy{};
+    module_stats stats;
+};
+
+plugin_registry::plugin_registry() {
+    for (const auto& factory : composite::static_factories()) {
+        m_static_factories.try_emplace(factory.name, factory);
+    }
+}
+
+plugin_registry::~plugin_registry() = default;
+
+auto plugin_registry::create(
+  std::string_view name,
+  std::optional<std::string_view> module,
+  std::optional<std::string_view> create_arg
+) -> std::shared_ptr<composite::component> {
+    const auto lock = std::scoped_lock{m_mtx};
+    // Factories linked into the executable take precedence
+    if (!module) {
+        if (auto iter = m_static_factories.find(name); iter != m_static_factories.end()) {
+            auto begin = std::chrono::steady_clock::now();
+            auto comp = invoke(iter->second, create_arg);
+            m_static_stats.create_time += elapsed_since(begin);
+            ++m_static_stats.created;
+            return comp;
+        }
+    }
+    auto path = fmt::format("lib{}.so", module.value_or(name));
+    auto& mod = load(path);
+    auto factory = mod.legacy;
+    if (!mod.factories.empty()) {
+        auto iter = mod.factories.find(name);
+        if (iter == mod.factories.end()) {
+            throw std::runtime_error(fmt::format("{} does not provide component '{}'", path, name));
+        }
+        factory = iter->second;
+    }
+    auto begin = std::chrono::steady_clock::now();
+    auto comp = invoke(factory, create_arg);
+    mod.stats.create_time += elapsed_since(begin);
+    ++mod.stats.created;
+    return comp;
+}
+
+auto plugin_registry::stats() const -> std::vector<module_stats> {
+    const auto lock = std::scoped_lock{m_mtx};
+    auto retval = std::vector<module_stats>{};
+    if (m_static_stats.created > 0) {
+        retval.emplace_back(m_static_stats);
+    }
+    for (const auto& [path, mod] : m_modules) {
+        retval.emplace_back(mod->stats);
+    }
+    return retval;
+}
+
+auto plugin_registry::load(const std::string& path) -> module& {
+    if (auto iter = m_modules.find(path); iter != m_modules.end()) {
+        return *iter->second;
+    }
+    auto begin = std::chrono::steady_clock::now();
+    auto mod = std::make_unique<module>();
+    mod->stats.path = path;
+    mod->handle.reset(dlopen(path.c_str(), RTLD_NOW));
+    if (!mod->handle) {
+        throw std::runtime_error(fmt::format("failed to open {}: {}", path, dlerror()));
+    }
+    dlerror(); // clear existing
+    // Prefer the factory table, falling back to a single 'create' symbol
+    if (auto table = reinterpret_cast<composite::factory_table_function>(dlsym(mod->handle.get(), composite::FACTORY_TABLE_SYMBOL))) {
+        auto count = std::size_t{};
+        auto factories = table(&count);
+        for (std::size_t i = 0; i < count; ++i) {
+            mod->factories.try_emplace(factories[i].name, factories[i]);
+        }
+    } else {
+        dlerror(); // clear existing
+        auto create = dlsym(mod->handle.get(), "create");
+        if (auto err = dlerror(); err != nullptr) {
+            throw std::runtime_error(fmt::format("failed to find the '{}' or 'create' symbol from {}: {}", composite::FACTORY_TABLE_SYMBOL, path, err));
+        }
+        // The legacy symbol's signature is chosen by whether a create_arg is given
+        mod->legacy = composite::component_factory{
+            mod->stats.path.c_str(),
+            reinterpret_cast<composite::create_function>(create),
+            reinterpret_cast<composite::create_with_arg_function>(create)
+        };
+    }
+    mod->stats.load_time = elapsed_since(begin);
+    return *m_modules.emplace(path, std::move(mod)).first->second;
+}
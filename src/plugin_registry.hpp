@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2024 Geon Technologies, LLC
+ *
+ * This file is part of composite.
+ *
+ * composite is free software: you can redistribute it and/or modify it under the
+ * terms of the GNU Lesser General Public License as published by the Free
+ * Software Foundation, either version 3 of the License, or (at your option)
+ * any later version.
+ *
+ * composite is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU Lesser General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+ 
+#pragma once
+
+#include "composite/component.hpp"
+#include "composite/plugin.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Loads each component module once and creates components by name, from
+// factories linked into the executable or exported by modules
+class plugin_registry {
+public:
+    struct module_stats {
+        std::string path;
+        std::chrono::nanoseconds load_time{};
+        std::size_t created{};
+        std::chrono::nanoseconds create_time{};
+    };
+
+    plugin_registry();
+    ~plugin_registry();
+
+    plugin_registry(const plugin_registry&) = delete;
+    auto operator=(const plugin_registry&) -> plugin_registry& = delete;
+
+    // Create a component of the named type. The module defaults to
+    // lib<name>.so; a module without a factory table must export 'create'.
+    // Throws std::runtime_error on failure.
+    auto create(
+      std::string_view name,
+      std::optional<std::string_view> module,
+      std::optional<std::string_view> create_arg
+    ) -> std::shared_ptr<composite::component>;
+
+    auto stats() const -> std::vector<module_stats>;
+
+private:
+    struct module;
+
+    auto load(const std::string& path) -> module&;
+
+    mutable std::mutex m_mtx;
+    std::map<std::string, composite::component_factory, std::less<>> m_static_factories;
+    std::map<std::string, std::unique_ptr<module>, std::less<>> m_modules;
+    module_stats m_static_stats{"<static>"};
+
+}; // class plugin_registry